@@ -104,17 +104,7 @@ Password_Check(const char *password)
     }
 
     // Rule #3 check
-    int rule_3_count = 0;
-
-    for (int i = 0; i < 26; ++i) {
-        if (rule_3_check & 0x01) {
-            rule_3_count++;
-        }
-
-        rule_3_check >>= 1;
-    }
-
-    rule_3 = rule_3_count >= 2;
+    rule_3 = __builtin_popcount(rule_3_check) >= 2;
 
     return rule_1 && rule_2 && rule_3;
 }
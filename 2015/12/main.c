@@ -41,18 +41,27 @@ value "red". Do this only for objects ({...}), not arrays ([...]).
 */
 
 static i64
-Calculate_SumOne(const char *data)
+Calculate_SumOne(Slice line)
 {
+    const char *data = line.data;
+    const char *end = line.data + line.size;
+
     i64 sum = 0;
 
-    while (*data != '\0') {
-        if (*data == '-' || isdigit(*data)) {
-            char *cursor = NULL;
-            sum += strtol(data, &cursor, 10);
-            data += cursor - data;
-        } else {
-            data++;
+    while (data < end) {
+        if (*data == '-' || isdigit((u8) *data)) {
+            i64 value;
+            u64 size = ParseInt_I64((Slice){data, (u64) (end - data)}, &value);
+
+            if (size > 0) {
+                sum += value;
+                data += size;
+
+                continue;
+            }
         }
+
+        data++;
     }
 
     return sum;
@@ -64,13 +73,13 @@ Calculate_SumOne(const char *data)
 static int red_count = 0;
 
 static const char *
-Skip_ObjectWithRed(const char *data)
+Skip_ObjectWithRed(const char *data, const char *end)
 {
     const char *cursor = data;
     u64 object_scope = 0;
     bool has_red_object = false;
 
-    while (*cursor != '\0') {
+    while (cursor < end) {
         if (*cursor == '{') {
             object_scope++;
         } else if (*cursor == '}') {
@@ -78,11 +87,11 @@ Skip_ObjectWithRed(const char *data)
         } else if (*cursor == ':' && has_red_object == false) {
             cursor++;
 
-            while (*cursor == ' ') {
+            while (cursor < end && *cursor == ' ') {
                 cursor++;
             }
 
-            if (memcmp(cursor, "\"red\"", 5) == 0) {
+            if (end - cursor >= 5 && memcmp(cursor, "\"red\"", 5) == 0) {
                 red_count++;
                 has_red_object = true;
 
@@ -98,7 +107,7 @@ Skip_ObjectWithRed(const char *data)
     }
 
     if (has_red_object) {
-        while (*cursor != '\0' && object_scope > 0) {
+        while (cursor < end && object_scope > 0) {
             if (*cursor == '}') {
                 object_scope--;
             }
@@ -113,20 +122,28 @@ Skip_ObjectWithRed(const char *data)
 }
 
 static i64
-Calculate_SumTwo(const char *data)
+Calculate_SumTwo(Slice line)
 {
+    const char *data = line.data;
+    const char *end = line.data + line.size;
+
     i64 sum = 0;
 
-    while (*data != '\0') {
+    while (data < end) {
         if (*data == '{') {
-            data = Skip_ObjectWithRed(data);
+            data = Skip_ObjectWithRed(data, end);
+
+            if (data == end) {
+                break;
+            }
         }
 
-        char *cursor = NULL;
+        i64 value;
+        u64 size = ParseInt_I64((Slice){data, (u64) (end - data)}, &value);
 
-        if (*data == '-' || isdigit(*data)) {
-            sum += strtol(data, &cursor, 10);
-            data += cursor - data;
+        if (size > 0) {
+            sum += value;
+            data += size;
         } else {
             data++;
         }
@@ -147,7 +164,7 @@ Part_One(Slice input)
             break;
         }
 
-        sum += Calculate_SumOne(line.data);
+        sum += Calculate_SumOne(line);
     }
 
     printf("Part one: sum %ld\n", sum);
@@ -165,7 +182,7 @@ Part_Two(Slice input)
             break;
         }
 
-        sum += Calculate_SumTwo(line.data);
+        sum += Calculate_SumTwo(line);
     }
 
     printf("Part two: sum %ld\n", sum);
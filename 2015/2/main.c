@@ -50,51 +50,14 @@ For example:
 How many total feet of ribbon should they order?
 */
 
+#define DIMENSION_FORMAT "%ux%ux%u"
+
 typedef struct Dimension {
     u64 length;
     u64 width;
     u64 height;
 } Dimension;
 
-static Dimension
-Dimension_Extract(const char *data)
-{
-    if (data == NULL) {
-        goto error;
-    }
-
-    Dimension result;
-
-    char *end;
-
-    result.length = strtoul(data, &end, 10);
-
-    if (errno == ERANGE) {
-        goto error;
-    }
-
-    end++;
-
-    result.width = strtoul(end, &end, 10);
-
-    if (errno == ERANGE) {
-        goto error;
-    }
-
-    end++;
-
-    result.height = strtoul(end, &end, 10);
-
-    if (errno == ERANGE) {
-        goto error;
-    }
-
-    return result;
-
-error:
-    Quit(2, "%s: invalid input '%s'.", NAME, data);
-}
-
 static u64
 Dimension_Area(Dimension dimension)
 {
@@ -137,41 +100,37 @@ Dimension_Length(Dimension dimension)
     return length + (dimension.length * dimension.width * dimension.height);
 }
 
+static Dimension
+Dimension_Get(const Scanner *scanner, u64 row)
+{
+    return (Dimension){
+        Scanner_Column(scanner, 0)[row],
+        Scanner_Column(scanner, 1)[row],
+        Scanner_Column(scanner, 2)[row]
+    };
+}
+
 void
-Part_One(Slice slice)
+Part_One(const Scanner *scanner)
 {
     u64 area = 0;
+    u64 rows = Scanner_Rows(scanner);
 
-    while (1) {
-        Slice line = Slice_ReadLine(&slice);
-
-        if (line.data == NULL) {
-            break;
-        }
-
-        Dimension dimension = Dimension_Extract(line.data);
-
-        area += Dimension_Area(dimension);
+    for (u64 row = 0; row < rows; ++row) {
+        area += Dimension_Area(Dimension_Get(scanner, row));
     }
 
     printf("Part one: square feet area %lu\n", area);
 }
 
 void
-Part_Two(Slice slice)
+Part_Two(const Scanner *scanner)
 {
     u64 length = 0;
+    u64 rows = Scanner_Rows(scanner);
 
-    while (1) {
-        Slice line = Slice_ReadLine(&slice);
-
-        if (line.data == NULL) {
-            break;
-        }
-
-        Dimension dimension = Dimension_Extract(line.data);
-
-        length += Dimension_Length(dimension);
+    for (u64 row = 0; row < rows; ++row) {
+        length += Dimension_Length(Dimension_Get(scanner, row));
     }
 
     printf("Part two: ribbon length %lu\n", length);
@@ -186,8 +145,15 @@ main(void)
         Quit(1, "%s: empty input.", NAME);
     }
 
-    Part_One(slice);
-    Part_Two(slice);
+    Scanner *scanner = NULL;
+
+    Scanner_Create(&scanner, DIMENSION_FORMAT);
+    Scanner_Parse(scanner, slice);
+
+    Part_One(scanner);
+    Part_Two(scanner);
+
+    Scanner_Destroy(&scanner);
 
     return 0;
 }
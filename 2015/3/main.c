@@ -50,67 +50,17 @@ For example:
 // East  >
 // West  <
 
-#include "map.h"
-
-#define MAP_SIZE 2048
-#define MAP_HASH_PRIME_1 251
-#define MAP_HASH_PRIME_2 457
+#include "sparse_grid.h"
 
 typedef struct MapKey {
     i32 x;
     i32 y;
 } MapKey;
 
-typedef u64 MapValue;
-
-typedef struct MapData {
-    MapKey *key;
-    MapValue *value;
-} MapData;
-
-static MapData
-Map_CreateData(MapKey key, MapValue value)
-{
-    MapData result;
-
-    result.key = malloc(sizeof(MapKey));
-    result.value = malloc(sizeof(MapValue));
-
-    if (result.key == NULL || result.value == NULL) {
-        Quit(3, "%s: out of memory.", NAME);
-    }
-
-    *result.key = key;
-    *result.value = value;
-
-    return result;
-}
-
-static u64
-Map_Hash(void *key)
-{
-    MapKey *map_key = (MapKey *) key;
-
-    u64 hash_value = (u64) (
-        (map_key->x * MAP_HASH_PRIME_1) +
-        (map_key->y * MAP_HASH_PRIME_2)
-    ) % (MAP_SIZE - 1);
-
-    if (hash_value >= MAP_SIZE) {
-        Quit(2, "%s: invalid hash: %lu\n", NAME, hash_value);
-    }
-
-    return hash_value;
-}
-
-static bool
-Map_Compare(void *left, void *right)
+static void
+Map_Visit(SparseGrid *grid, MapKey key)
 {
-    MapKey *key_left = (MapKey *) left;
-    MapKey *key_right = (MapKey *) right;
-
-    return key_left->x == key_right->x &&
-           key_left->y == key_right->y;
+    SparseGrid_SetIfUnset(grid, key.x, key.y);
 }
 
 static void
@@ -130,79 +80,61 @@ Map_Move(MapKey *key, char movement)
 void
 Part_One(const char *data)
 {
-    u64 houses = 0;
-
     MapKey santa = {0,0};
 
-    Map *map = NULL;
-
-    Map_Create(&map, MAP_SIZE, Map_Hash, Map_Compare);
+    SparseGrid *grid = NULL;
 
-    MapData map_data = Map_CreateData(santa, 0);
+    SparseGrid_Create(&grid);
 
-    Map_Insert(map, map_data.key, map_data.value);
+    Map_Visit(grid, santa);
 
     while (*data != '\n' && *data != '\0') {
         Map_Move(&santa, *data);
-
-        map_data = Map_CreateData(santa, 0);
-
-        if (Map_Insert(map, map_data.key, map_data.value)) {
-            houses++;
-        }
+        Map_Visit(grid, santa);
 
         data++;
     }
 
-    Map_Destroy(&map);
+    u64 houses = SparseGrid_Count(grid);
+
+    SparseGrid_Destroy(&grid);
 
-    printf("Part one: %lu houses\n", houses + 1);
+    printf("Part one: %lu houses\n", houses);
 }
 
 void
 Part_Two(const char *data)
 {
-    u64 houses_santa = 0;
-    u64 houses_robot = 0;
-
     MapKey santa = {0,0};
     MapKey robot = {0,0};
 
-    Map *map = NULL;
+    SparseGrid *grid = NULL;
 
-    Map_Create(&map, MAP_SIZE, Map_Hash, Map_Compare);
+    SparseGrid_Create(&grid);
 
-    MapData map_data = Map_CreateData(santa, 0);
-    Map_Insert(map, map_data.key, map_data.value);
+    Map_Visit(grid, santa);
+    Map_Visit(grid, robot);
 
     u8 santa_turn = true;
 
     while (*data != '\0') {
         if (santa_turn) {
             Map_Move(&santa, *data);
-
-            map_data = Map_CreateData(santa, 0);
-
-            if (Map_Insert(map, map_data.key, map_data.value)) {
-                houses_santa++;
-            }
+            Map_Visit(grid, santa);
         } else {
             Map_Move(&robot, *data);
-
-            map_data = Map_CreateData(robot, 0);
-
-            if (Map_Insert(map, map_data.key, map_data.value)) {
-                houses_robot++;
-            }
+            Map_Visit(grid, robot);
         }
 
         santa_turn ^= true;
         data++;
     }
 
-    Map_Destroy(&map);
+    u64 houses = SparseGrid_Count(grid);
+
+    SparseGrid_Destroy(&grid);
 
-    printf("Part two: %lu houses\n", houses_santa + houses_robot + 1);
+    printf("Part two: %lu houses\n", houses);
 }
 
 int
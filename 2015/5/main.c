@@ -57,38 +57,43 @@ How many strings are nice under these new rules?
 
 */
 
+static const Slice Forbidden[] = {
+    { "ab", 2 },
+    { "cd", 2 },
+    { "pq", 2 },
+    { "xy", 2 },
+};
+
+static Matcher *ForbiddenMatcher = NULL;
+
+// The forbidden pairs are matched in the same pass as the other two rules.
 static bool
 IsNiceOne(Slice str)
 {
     i64 vowels = 0;
     bool has_doubles = false;
+    u32 state = 0;
+
+    for (u64 i = 0; i < str.size; ++i) {
+        char ch = str.data[i];
 
-    for (u64 i = 1; i <= str.size; ++i) {
-        char ch1 = str.data[i - 1];
-        char ch2 = str.data[i];
+        if (Matcher_Step(ForbiddenMatcher, &state, ch)) {
+            return false;
+        }
 
         if (
-            (ch1 == 'a') || (ch1 == 'A') ||
-            (ch1 == 'e') || (ch1 == 'E') ||
-            (ch1 == 'i') || (ch1 == 'I') ||
-            (ch1 == 'o') || (ch1 == 'O') ||
-            (ch1 == 'u') || (ch1 == 'U')
+            (ch == 'a') || (ch == 'A') ||
+            (ch == 'e') || (ch == 'E') ||
+            (ch == 'i') || (ch == 'I') ||
+            (ch == 'o') || (ch == 'O') ||
+            (ch == 'u') || (ch == 'U')
         ) {
             vowels++;
         }
 
-        if (!has_doubles && ch1 == ch2) {
+        if (!has_doubles && i > 0 && str.data[i - 1] == ch) {
             has_doubles = true;
         }
-
-        if (
-            ((ch1 == 'a' || ch1 == 'A') && (ch2 == 'b' || ch2 == 'B')) ||
-            ((ch1 == 'c' || ch1 == 'C') && (ch2 == 'd' || ch2 == 'D')) ||
-            ((ch1 == 'p' || ch1 == 'P') && (ch2 == 'q' || ch2 == 'Q')) ||
-            ((ch1 == 'x' || ch1 == 'X') && (ch2 == 'y' || ch2 == 'Y'))
-        ) {
-            return false;
-        }
     }
 
     return (vowels >= 3) && has_doubles;
@@ -176,9 +181,13 @@ main(void)
         Quit(1, "%s: empty input.", NAME);
     }
 
+    Matcher_Create(&ForbiddenMatcher, Forbidden, sizeof(Forbidden) / sizeof(Forbidden[0]), true);
+
     Part_One(input);
     Part_Two(input);
 
+    Matcher_Destroy(&ForbiddenMatcher);
+
     return 0;
 }
 
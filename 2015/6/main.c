@@ -69,6 +69,8 @@ typedef enum Action {
     , Toggle
 } Action;
 
+#include "Action_Lookup.h"
+
 typedef struct Coordinate {
     u16 row;
     u16 col;
@@ -88,9 +90,6 @@ u16 grid[GRID_ROWS][GRID_COLS] = {0};
 
 typedef void (* Grid_Apply)(Coordinate coordinate);
 
-static const Slice ActionOn = { "turn on", 7 };
-static const Slice ActionOff = { "turn off", 8 };
-static const Slice ActionToggle = { "toggle", 6 };
 static const Slice DataDivision = { "through", 7 };
 
 static void
@@ -107,34 +106,6 @@ Grid_CheckRange(Range range)
     }
 }
 
-static void
-Grid_Reset()
-{
-    for (u16 row = 0; row < GRID_ROWS; ++row) {
-        for (u16 col = 0; col < GRID_COLS; ++col) {
-            grid[row][col] = 0;
-        }
-    }
-}
-
-static void
-Grid_OnOne(Coordinate coordinate)
-{
-    grid[coordinate.row][coordinate.col] = true;
-}
-
-static void
-Grid_OffOne(Coordinate coordinate)
-{
-    grid[coordinate.row][coordinate.col] = false;
-}
-
-static void
-Grid_ToggleOne(Coordinate coordinate)
-{
-    grid[coordinate.row][coordinate.col] ^= true;
-}
-
 static void
 Grid_OnTwo(Coordinate coordinate)
 {
@@ -155,44 +126,36 @@ Grid_ToggleTwo(Coordinate coordinate)
     grid[coordinate.row][coordinate.col] += 2;
 }
 
+// Each row of the range is a run of consecutive bits, applied a word at a time.
 static void
-Grid_ForRange(Range range, Grid_Apply apply)
+Lights_ForRange(Bitset *lights, Range range, Action action)
 {
     Grid_CheckRange(range);
 
     for (u16 row = range.start.row; row <= range.end.row; ++row) {
-        for (u16 col = range.start.col; col <= range.end.col; ++col) {
-            apply((Coordinate){row, col});
+        u64 first = (u64) row * GRID_COLS + range.start.col;
+        u64 last = (u64) row * GRID_COLS + range.end.col + 1;
+
+        if (action == On) {
+            Bitset_SetRange(lights, first, last);
+        } else if (action == Off) {
+            Bitset_ClearRange(lights, first, last);
+        } else if (action == Toggle) {
+            Bitset_FlipRange(lights, first, last);
         }
     }
 }
 
-u64
-Grid_Count(Action action)
+static void
+Grid_ForRange(Range range, Grid_Apply apply)
 {
-    u64 count = 0;
-
-    if (action != On && action != Off) {
-        Quit(4, "%s: invalid action (%d).", action);
-    }
-
-    for (u16 row = 0; row < GRID_ROWS; ++row) {
-        for (u16 col = 0; col < GRID_COLS; ++col) {
-            u16 data = grid[row][col];
-
-            while (data) {
-                if (action == On && (data & 0x01)) {
-                    count++;
-                } else if (action == Off && ((data & 0x01) == 0)) {
-                    count++;
-                }
+    Grid_CheckRange(range);
 
-                data >>= 1;
-            }
+    for (u16 row = range.start.row; row <= range.end.row; ++row) {
+        for (u16 col = range.start.col; col <= range.end.col; ++col) {
+            apply((Coordinate){row, col});
         }
     }
-
-    return count;
 }
 
 u64
@@ -223,72 +186,86 @@ Skip_Spaces(const char *input)
     return input;
 }
 
-static Input
-Parse_Input(const char *input) {
-    Input result = { Invalid, {{0,0},{0,0}} };
+static const char *
+Parse_Coordinate(const char *cursor, const char *end, Coordinate *coordinate)
+{
+    cursor = Skip_Spaces(cursor);
 
-    const char *cursor = input;
-
-    if (memcmp(cursor, ActionOn.data, ActionOn.size) == 0) {
-        result.action = On;
-        cursor += ActionOn.size;
-    } else if (memcmp(cursor, ActionOff.data, ActionOff.size) == 0) {
-        result.action = Off;
-        cursor += ActionOff.size;
-    } else if (memcmp(cursor, ActionToggle.data, ActionToggle.size) == 0) {
-        result.action = Toggle;
-        cursor += ActionToggle.size;
-    } else {
-        goto error;
+    u64 size = ParseInt_U16((Slice){cursor, (u64) (end - cursor)}, &coordinate->row);
+
+    if (size == 0 || cursor + size >= end || cursor[size] != ',') {
+        return NULL;
     }
 
-    char *end;
+    cursor += size + 1;
 
-    result.range.start.row = (u16) strtoul(cursor, &end, 10);
+    size = ParseInt_U16((Slice){cursor, (u64) (end - cursor)}, &coordinate->col);
 
-    if (errno == ERANGE || cursor == end) {
-        goto error;
+    if (size == 0) {
+        return NULL;
     }
 
-    cursor = end + 1;
+    return cursor + size;
+}
+
+static Input
+Parse_Input(Slice line) {
+    Input result = { Invalid, {{0,0},{0,0}} };
 
-    result.range.start.col = (u16) strtoul(cursor, &end, 10);
+    const char *end = line.data + line.size;
 
-    if (errno == ERANGE || cursor == end) {
-        goto error;
+    // The action is everything before the first coordinate.
+    Slice action = {line.data, 0};
+
+    while (action.size < line.size && !isdigit((u8) line.data[action.size])) {
+        action.size++;
+    }
+
+    const char *cursor = line.data + action.size;
+
+    while (action.size > 0 && action.data[action.size - 1] == ' ') {
+        action.size--;
     }
 
-    cursor = Skip_Spaces(end);
+    result.action = Action_Lookup(action);
 
-    if (memcmp(cursor, DataDivision.data, DataDivision.size) != 0) {
+    if (result.action == Invalid) {
         goto error;
     }
 
-    cursor += DataDivision.size;
+    cursor = Parse_Coordinate(cursor, end, &result.range.start);
+
+    if (cursor == NULL) {
+        goto error;
+    }
 
-    result.range.end.row = (u16) strtoul(cursor, &end, 10);
+    cursor = Skip_Spaces(cursor);
 
-    if (errno == ERANGE || cursor == end) {
+    if (!Slice_StartWith((Slice){cursor, (u64) (end - cursor)}, DataDivision)) {
         goto error;
     }
 
-    cursor = end + 1;
+    cursor += DataDivision.size;
 
-    result.range.end.col = (u16) strtoul(cursor, &end, 10);
+    cursor = Parse_Coordinate(cursor, end, &result.range.end);
 
-    if (errno == ERANGE || cursor == end) {
+    if (cursor == NULL) {
         goto error;
     }
 
     return result;
 
 error:
-    Quit(3, "%s: invalid input '%s'.", NAME, input);
+    Quit(3, "%s: invalid input '%.*s'.", NAME, (int) line.size, line.data);
 }
 
 void
 Part_One(Slice data)
 {
+    Bitset *lights = NULL;
+
+    Bitset_Create(&lights, GRID_ROWS * GRID_COLS);
+
     while (1) {
         Slice line = Slice_ReadLine(&data);
 
@@ -296,18 +273,14 @@ Part_One(Slice data)
             break;
         }
 
-        Input input = Parse_Input(line.data);
+        Input input = Parse_Input(line);
 
-        if (input.action == On) {
-            Grid_ForRange(input.range, Grid_OnOne);
-        } else if (input.action == Off) {
-            Grid_ForRange(input.range, Grid_OffOne);
-        } else if (input.action == Toggle) {
-            Grid_ForRange(input.range, Grid_ToggleOne);
-        }
+        Lights_ForRange(lights, input.range, input.action);
     }
 
-    printf("Part one: %lu lighs on\n", Grid_Count(On));
+    printf("Part one: %lu lighs on\n", Bitset_Count(lights));
+
+    Bitset_Destroy(&lights);
 }
 
 void
@@ -320,7 +293,7 @@ Part_Two(Slice data)
             break;
         }
 
-        Input input = Parse_Input(line.data);
+        Input input = Parse_Input(line);
 
         if (input.action == On) {
             Grid_ForRange(input.range, Grid_OnTwo);
@@ -344,7 +317,6 @@ main(void)
     }
 
     Part_One(input);
-    Grid_Reset();
     Part_Two(input);
 
     return 0;
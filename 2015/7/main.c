@@ -73,6 +73,8 @@ typedef enum {
     , OPR_RSHIFT
 } Operator;
 
+#include "Operator_Lookup.h"
+
 typedef enum {
       TTP_INVALID
     , TTP_OPERATOR
@@ -103,10 +105,7 @@ typedef struct Command {
     Register destiny;
 } Command;
 
-typedef struct CommandList {
-    Command command;
-    struct CommandList *next;
-} CommandList;
+DEFINE_VEC(CommandList, Command)
 
 typedef struct Token {
     TokenType type;
@@ -124,6 +123,8 @@ typedef struct Token {
 
 #define TOKEN_DELIMITER " "
 
+#define COMMAND_LIST_SIZE 512
+
 u32 SingleSignal[SIGNAL_BUFFER_SIZE];
 u32 DoubleSignal[SIGNAL_BUFFER_SIZE * SIGNAL_BUFFER_SIZE];
 
@@ -134,13 +135,6 @@ static const Command InvalidCommand = {
     .destiny = {0}
 };
 
-static const Slice OperatorAssign = { "->", 2 };
-static const Slice OperatorAnd = { "AND", 3 };
-static const Slice OperatorOr = { "OR", 2 };
-static const Slice OperatorNot = { "NOT", 3 };
-static const Slice OperatorLShift = { "LSHIFT", 6 };
-static const Slice OperatorRShift = { "RSHIFT", 6 };
-
 static bool
 Signal_IsValid(const Register reg)
 {
@@ -218,24 +212,11 @@ Token_Parse(Slice token)
 {
     Token result = {0};
 
-    if (Slice_Equals(OperatorAssign, token)) {
-        result.type = TTP_OPERATOR;
-        result.operator = OPR_ASSIGN;
-    } else if (Slice_Equals(OperatorAnd, token)) {
-        result.type = TTP_OPERATOR;
-        result.operator = OPR_AND;
-    } else if (Slice_Equals(OperatorOr, token)) {
-        result.type = TTP_OPERATOR;
-        result.operator = OPR_OR;
-    } else if (Slice_Equals(OperatorNot, token)) {
-        result.type = TTP_OPERATOR;
-        result.operator = OPR_NOT;
-    } else if (Slice_Equals(OperatorLShift, token)) {
-        result.type = TTP_OPERATOR;
-        result.operator = OPR_LSHIFT;
-    } else if (Slice_Equals(OperatorRShift, token)) {
+    Operator operator = Operator_Lookup(token);
+
+    if (operator != OPR_INVALID) {
         result.type = TTP_OPERATOR;
-        result.operator = OPR_RSHIFT;
+        result.operator = operator;
     } else if (
         (token.data[0] >= 'a' && token.data[1] <= 'z') &&
         (!isdigit(token.data[1]) || (token.data[1] >= 'a' && token.data[1] <= 'z' && !isdigit(token.data[2])))
@@ -454,53 +435,24 @@ Command_Execute(Command command)
     }
 }
 
-static void
-CommandList_Insert(CommandList **list, Command command)
-{
-    CommandList *item = malloc(sizeof(struct CommandList));
-
-    item->command = command;
-    item->next = *list;
-
-    *list = item;
-}
-
+// Runs every pending command whose operands are ready and returns how many are
+// still waiting. Order does not matter, a command only runs once its inputs
+// are final.
 static u32
-CommandList_Execute(CommandList **list)
+CommandList_Execute(CommandList *list)
 {
-    u32 pending = 0;
-
-    if (list == NULL || *list == NULL) {
-        return pending;
-    }
-
-    CommandList *item = *list;
-    CommandList *parent = NULL;
+    u64 index = 0;
 
-    while (item != NULL) {
-        if (Command_IsExecutable(item->command)) {
-            CommandList *current = item;
-
-            item = current->next;
-
-            if (parent) {
-                parent->next = item;
-            } else {
-                *list = item;
-            }
-
-            Command_Execute(current->command);
-
-            free(current);
+    while (index < list->count) {
+        if (Command_IsExecutable(list->items[index])) {
+            Command_Execute(list->items[index]);
+            CommandList_SwapRemove(list, index);
         } else {
-            pending++;
-
-            parent = item;
-            item = item->next;
+            index++;
         }
     }
 
-    return pending;
+    return (u32) list->count;
 }
 
 static void
@@ -508,6 +460,8 @@ Program_Run(Slice program)
 {
     CommandList *list = NULL;
 
+    CommandList_Create(&list, COMMAND_LIST_SIZE);
+
     while (1) {
         Slice line = Slice_ReadLine(&program);
 
@@ -517,27 +471,31 @@ Program_Run(Slice program)
             continue;
         }
 
-        CommandList_Execute(&list);
+        CommandList_Execute(list);
 
         Command command = Command_Parse(line);
 
         if (Command_IsExecutable(command)) {
             Command_Execute(command);
         } else {
-            CommandList_Insert(&list, command);
+            CommandList_Push(list, command);
         }
     }
 
-    u32 pending_current = CommandList_Execute(&list);
+    u32 pending_current = CommandList_Execute(list);
     u32 pending_last = pending_current;
 
-    while (list != NULL) {
-        pending_current = CommandList_Execute(&list);
+    while (list->count > 0) {
+        pending_current = CommandList_Execute(list);
 
         if (pending_current == pending_last) {
             Quit(2, "%s: not all command could be run (%s).", NAME, __func__);
         }
+
+        pending_last = pending_current;
     }
+
+    CommandList_Destroy(&list);
 }
 
 void
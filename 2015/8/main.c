@@ -87,112 +87,76 @@ error_input:
 }
 
 static u64
-Count_CharsInMemory(const char *str)
+Count_CharsInMemory(Slice str)
 {
-    if (str == NULL) {
+    if (str.data == NULL) {
         GOTO(error_input);
     }
 
-    u64 length = strlen(str);
-
-    if (str[0] != '"' || str[length - 1] != '"') {
+    if (str.size < 2 || str.data[0] != '"' || str.data[str.size - 1] != '"') {
         GOTO(error_input);
     }
 
-    length -= 2;
-
-    if (length == 0) {
-        return 0;
-    }
-
-    const char *cursor = &str[1];
+    u64 length = Slice_Unescape((Slice){str.data + 1, str.size - 2}, NULL);
 
-    u64 result = 0;
-
-    while (length > 0) {
-        if (*cursor == '\\') {
-            if (length == 1) {
-                GOTO(error_input);
-            } else if (cursor[1] == '"' || cursor[1] == '\\') {
-                cursor += 2;
-                length -= 2;
-            } else if (cursor[1] == 'x') {
-                cursor += 4;
-                length -= 4;
-            }
-        } else {
-            cursor++;
-            length--;
-        }
-
-        result++;
+    if (length == SLICE_INVALID) {
+        GOTO(error_input);
     }
 
-    return result;
+    return length;
 
 error_input:
     Quit(2, "%s: invalid input in %s at %s:%d.", NAME, DebugFunction, DebugFile, DebugLine);
 }
 
 static u64
-Count_CharsEncoded(const char *str)
+Count_CharsEncoded(Slice str)
 {
-    UNUSED(str);
-
-    u64 length = strlen(str);
-    u64 result = 0;
-
-    while (*str != '\0') {
-        if (*str == '"' || *str == '\\') {
-            if (length == 1) {
-                GOTO(error_input);
-            } else {
-                result += 2;
-            }
-        } else {
-            result++;
-        }
-
-        str++;
+    if (str.data == NULL) {
+        GOTO(error_input);
     }
 
-    return result + 2;
+    return Slice_Escape(str, NULL);
 
 error_input:
     Quit(2, "%s: invalid input in %s at %s:%d.", NAME, DebugFunction, DebugFile, DebugLine);
 }
 
 void
-Part_One(Slice input, u64 chars_in_file )
+Part_One(const Slice input, u64 chars_in_file)
 {
     u64 chars_in_memory = 0;
 
+    SliceIterator lines = Slice_Iterate(input);
+
     while (1) {
-        Slice line = Slice_ReadLine(&input);
+        Slice line = SliceIterator_NextLine(&lines);
 
         if (line.data == NULL) {
             break;
         }
 
-        chars_in_memory += Count_CharsInMemory(line.data);
+        chars_in_memory += Count_CharsInMemory(line);
     }
 
     printf("Part one: char count %lu\n", chars_in_file - chars_in_memory);
 }
 
 void
-Part_Two(Slice input, u64 chars_in_file)
+Part_Two(const Slice input, u64 chars_in_file)
 {
     u64 chars_encoded = 0;
 
+    SliceIterator lines = Slice_Iterate(input);
+
     while (1) {
-        Slice line = Slice_ReadLine(&input);
+        Slice line = SliceIterator_NextLine(&lines);
 
         if (line.data == NULL) {
             break;
         }
 
-        chars_encoded += Count_CharsEncoded(line.data);
+        chars_encoded += Count_CharsEncoded(line);
     }
 
     printf("Part two: char count %lu\n", chars_encoded - chars_in_file);
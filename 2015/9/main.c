@@ -69,6 +69,11 @@ typedef struct TreeNode {
 
 TreeNode *tree = NULL;
 
+// Nodes and connections are freed while the path is searched, the pools keep
+// their slots for the next allocations instead of returning them to the heap.
+static Pool *NodePool = NULL;
+static Pool *ConnectionPool = NULL;
+
 typedef TreeConnection * (*Tree_FindFunction)(u64 id, TreeNode **node);
 
 u64
@@ -94,11 +99,7 @@ Hash_PJW(const void *data)
 TreeNode *
 Tree_NewNode(void)
 {
-    TreeNode *node = malloc(sizeof(struct TreeNode));
-
-    if (!node) {
-        Quit(0, "%s: out of memory.", NAME);
-    }
+    TreeNode *node = POOL_PUSH(NodePool, TreeNode);
 
     node->name[0] = '\0';
     node->id = 0;
@@ -111,11 +112,7 @@ Tree_NewNode(void)
 TreeConnection *
 Tree_NewConnection(void)
 {
-    TreeConnection *connection = malloc(sizeof(struct TreeConnection));
-
-    if (!connection) {
-        Quit(0, "%s: out of memory.", NAME);
-    }
+    TreeConnection *connection = POOL_PUSH(ConnectionPool, TreeConnection);
 
     connection->distance = 0;
     connection->node = NULL;
@@ -220,7 +217,7 @@ Tree_Remove(u64 id)
 
                     connection = connection->next;
 
-                    free(connection_to_free);
+                    Pool_Free(ConnectionPool, connection_to_free);
 
                     continue;
                 }
@@ -245,7 +242,7 @@ Tree_Remove(u64 id)
                 connection_to_free = connection;
                 connection = connection->next;
 
-                free(connection_to_free);
+                Pool_Free(ConnectionPool, connection_to_free);
             }
 
             if (parent) {
@@ -254,7 +251,7 @@ Tree_Remove(u64 id)
                 tree = node->next;
             }
 
-            free(node);
+            Pool_Free(NodePool, node);
 
             break;
         }
@@ -365,6 +362,39 @@ Tree_FindPath(Tree_FindFunction find_function)
     return path;
 }
 
+// Reads "<city> to <city> = <distance>" and adds the connection to the tree.
+static void
+Parse_Route(Slice line)
+{
+    Slice route = line;
+
+    Slice token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
+    strncpy(City_1, token.data, token.size);
+    City_1[token.size] = '\0';
+
+    Slice_Token(&line, TOKEN_CITY_DELIMITER);
+
+    token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
+    strncpy(City_2, token.data, token.size);
+    City_2[token.size] = '\0';
+
+    Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
+    token = Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
+
+    while (token.size > 0 && *token.data == ' ') {
+        token.data++;
+        token.size--;
+    }
+
+    u64 distance = 0;
+
+    if (ParseInt_U64(token, &distance) == 0) {
+        Quit(2, "%s: invalid distance in '%.*s'.", NAME, (int) route.size, route.data);
+    }
+
+    Tree_Insert(City_1, City_2, distance);
+}
+
 void
 Part_One(Slice input)
 {
@@ -375,22 +405,7 @@ Part_One(Slice input)
             break;
         }
 
-        Slice token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
-        strncpy(City_1, token.data, token.size);
-        City_1[token.size] = '\0';
-
-        Slice_Token(&line, TOKEN_CITY_DELIMITER);
-
-        token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
-        strncpy(City_2, token.data, token.size);
-        City_2[token.size] = '\0';
-
-        Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
-        token = Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
-
-        u64 distance = strtoul(token.data, NULL, 10);
-
-        Tree_Insert(City_1, City_2, distance);
+        Parse_Route(line);
     }
 
     u64 shortest_path = Tree_FindPath(Tree_FindSmallest);
@@ -408,22 +423,7 @@ Part_Two(Slice input)
             break;
         }
 
-        Slice token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
-        strncpy(City_1, token.data, token.size);
-        City_1[token.size] = '\0';
-
-        Slice_Token(&line, TOKEN_CITY_DELIMITER);
-
-        token = Slice_Token(&line, TOKEN_CITY_DELIMITER);
-        strncpy(City_2, token.data, token.size);
-        City_2[token.size] = '\0';
-
-        Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
-        token = Slice_Token(&line, TOKEN_DISTANCE_DELIMITER);
-
-        u64 distance = strtoul(token.data, NULL, 10);
-
-        Tree_Insert(City_1, City_2, distance);
+        Parse_Route(line);
     }
 
     Tree_Print();
@@ -443,10 +443,16 @@ main(void)
         Quit(1, "%s: empty input.", NAME);
     }
 
+    Pool_Create(&NodePool, (PoolConfig) {.object_size = sizeof(TreeNode)});
+    Pool_Create(&ConnectionPool, (PoolConfig) {.object_size = sizeof(TreeConnection)});
+
     //Part_One(input);
     //puts("==================================");
     Part_Two(input);
 
+    Pool_Destroy(&ConnectionPool);
+    Pool_Destroy(&NodePool);
+
     return 0;
 }
 
@@ -0,0 +1,38 @@
+# Copyright (c) 2023 Gustavo Ribeiro Croscato
+# SPDX-License-Identifier: MIT
+
+# target_keywords(<target> FILE <list> TYPE <enum> FUNCTION <name> INVALID <value>)
+#
+# Generates <name>.h from a keyword list with the tools/keywords generator
+# and makes it includable from <target>. The header defines
+# "static inline <enum> <name>(const Slice token)", so it must be included
+# after the enum is declared.
+function(target_keywords target)
+    cmake_parse_arguments(PARSE_ARGV 1 keywords "" "FILE;TYPE;FUNCTION;INVALID" "")
+
+    if(NOT keywords_FILE OR NOT keywords_TYPE OR NOT keywords_FUNCTION OR NOT keywords_INVALID)
+        message(FATAL_ERROR "target_keywords: FILE, TYPE, FUNCTION and INVALID are required.")
+    endif()
+
+    cmake_path(ABSOLUTE_PATH keywords_FILE BASE_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR})
+
+    # The generator names its input in the header comment, so hand it a
+    # source-relative path to keep build machine paths out of the output.
+    file(RELATIVE_PATH keywords_SOURCE ${CMAKE_SOURCE_DIR} ${keywords_FILE})
+
+    set(output_dir ${CMAKE_CURRENT_BINARY_DIR}/keywords)
+    set(output ${output_dir}/${keywords_FUNCTION}.h)
+
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${output_dir}
+        COMMAND keywords ${keywords_SOURCE} ${output} ${keywords_TYPE} ${keywords_FUNCTION} ${keywords_INVALID}
+        DEPENDS keywords ${keywords_FILE}
+        WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
+        COMMENT "Generating keyword lookup ${keywords_FUNCTION}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${output})
+    target_include_directories(${target} PRIVATE ${output_dir})
+endfunction()
@@ -0,0 +1,138 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+struct ArenaBlock {
+    struct ArenaBlock *next;
+    u64 size;
+    max_align_t data[];
+};
+
+struct Arena {
+    ArenaBlock *first;
+    ArenaBlock *current;
+    u64 offset;
+
+    u64 block_size;
+};
+
+static ArenaBlock *
+Arena_CreateBlock(u64 size)
+{
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+
+    if (block == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    block->next = NULL;
+    block->size = size;
+
+    return block;
+}
+
+// Offset inside block where an allocation of size and alignment starts, or
+// UINT64_MAX when it does not fit.
+static inline u64
+Arena_Fit(const ArenaBlock *block, u64 offset, u64 size, u64 alignment)
+{
+    uintptr_t base = (uintptr_t) block->data;
+    uintptr_t start = (base + offset + alignment - 1) & ~(uintptr_t) (alignment - 1);
+
+    offset = (u64) (start - base);
+
+    if (offset > block->size || block->size - offset < size) {
+        return UINT64_MAX;
+    }
+
+    return offset;
+}
+
+void
+Arena_Create(Arena **arena, u64 block_size)
+{
+    *arena = malloc(sizeof(Arena));
+
+    if (*arena == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    (*arena)->first = Arena_CreateBlock(block_size);
+    (*arena)->current = (*arena)->first;
+    (*arena)->offset = 0;
+    (*arena)->block_size = block_size;
+}
+
+void
+Arena_Destroy(Arena **arena)
+{
+    if (arena == NULL || *arena == NULL) {
+        return;
+    }
+
+    ArenaBlock *block = (*arena)->first;
+
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+
+        free(block);
+
+        block = next;
+    }
+
+    free(*arena);
+
+    *arena = NULL;
+}
+
+void *
+Arena_Alloc(Arena *arena, u64 size, u64 alignment)
+{
+    u64 offset = Arena_Fit(arena->current, arena->offset, size, alignment);
+
+    // Blocks after the current one are left over from a restore, reuse them
+    // before asking for a new one.
+    while (offset == UINT64_MAX) {
+        ArenaBlock *next = arena->current->next;
+
+        if (next == NULL || next->size < size + alignment) {
+            u64 block_size = arena->block_size;
+
+            if (block_size < size + alignment) {
+                block_size = size + alignment;
+            }
+
+            ArenaBlock *block = Arena_CreateBlock(block_size);
+
+            block->next = next;
+            arena->current->next = block;
+            next = block;
+        }
+
+        arena->current = next;
+        offset = Arena_Fit(next, 0, size, alignment);
+    }
+
+    arena->offset = offset + size;
+
+    return (u8 *) arena->current->data + offset;
+}
+
+ArenaMark
+Arena_Mark(const Arena *arena)
+{
+    return (ArenaMark) {arena->current, arena->offset};
+}
+
+void
+Arena_Restore(Arena *arena, ArenaMark mark)
+{
+    arena->current = mark.block;
+    arena->offset = mark.offset;
+}
+
+void
+Arena_Reset(Arena *arena)
+{
+    arena->current = arena->first;
+    arena->offset = 0;
+}
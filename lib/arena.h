@@ -0,0 +1,34 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef ARENA_H
+#define ARENA_H 1
+
+// Bump allocator over a chain of blocks. Allocations are never freed one by
+// one: Arena_Restore releases everything allocated after a mark and
+// Arena_Reset everything at once, keeping the blocks for reuse.
+typedef struct Arena Arena;
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct ArenaMark {
+    ArenaBlock *block;
+    u64 offset;
+} ArenaMark;
+
+#define ARENA_PUSH(arena, Type) ((Type *) Arena_Alloc((arena), sizeof(Type), _Alignof(Type)))
+#define ARENA_PUSH_ARRAY(arena, Type, count) \
+    ((Type *) Arena_Alloc((arena), sizeof(Type) * (count), _Alignof(Type)))
+
+// block_size is the size of each block, larger allocations get a block of
+// their own.
+void Arena_Create(Arena **arena, u64 block_size);
+void Arena_Destroy(Arena **arena);
+
+// alignment must be a power of two.
+void *Arena_Alloc(Arena *arena, u64 size, u64 alignment);
+
+ArenaMark Arena_Mark(const Arena *arena);
+void Arena_Restore(Arena *arena, ArenaMark mark);
+void Arena_Reset(Arena *arena);
+
+#endif // ARENA_H
@@ -0,0 +1,507 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Reads a regular file through io_uring with several chunk reads in flight
+// and hands whole-line, '\0' terminated windows to a callback, in file
+// order, while the following reads are still pending. Pipes, kernels
+// without io_uring and builds without LIB_C_IO_URING fall back to the
+// synchronous SliceReader with the same callback contract.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(LIB_C_IO_URING)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#endif
+
+#define ASYNC_READER_CHUNK_SIZE (1024 * 1024)
+#define ASYNC_READER_DEPTH 4
+
+#if defined(LIB_C_IO_URING)
+
+typedef struct AsyncReaderCarry {
+    char *data;
+    u64 size;
+    u64 capacity;
+} AsyncReaderCarry;
+
+static void
+AsyncReader_Append(AsyncReaderCarry *carry, const char *data, u64 size)
+{
+    if (carry->size + size + 1 > carry->capacity) {
+        u64 capacity = carry->capacity ? carry->capacity : ASYNC_READER_CHUNK_SIZE;
+
+        while (carry->size + size + 1 > capacity) {
+            capacity *= 2;
+        }
+
+        char *grown = realloc(carry->data, capacity);
+
+        if (grown == NULL) {
+            Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+        }
+
+        carry->data = grown;
+        carry->capacity = capacity;
+    }
+
+    memcpy(carry->data + carry->size, data, size);
+
+    carry->size += size;
+}
+
+// Delivers the whole lines of one chunk. A line split between chunks is
+// assembled in the carry buffer and delivered on its own, so the rest of the
+// chunk goes to the callback straight from the read buffer. The buffer must
+// have one spare byte after size.
+static bool
+AsyncReader_Deliver(char *buffer, u64 size, bool last, AsyncReaderCarry *carry, AsyncReaderCallback callback, void *context)
+{
+    u64 start = 0;
+
+    if (carry->size > 0) {
+        const char *newline = memchr(buffer, '\n', size);
+
+        if (newline == NULL && !last) {
+            AsyncReader_Append(carry, buffer, size);
+
+            return true;
+        }
+
+        start = (newline == NULL) ? size : (u64) (newline - buffer) + 1;
+
+        AsyncReader_Append(carry, buffer, start);
+
+        carry->data[carry->size] = '\0';
+
+        Slice line = {carry->data, carry->size};
+
+        carry->size = 0;
+
+        if (!callback(line, context)) {
+            return false;
+        }
+    }
+
+    u64 end = size;
+
+    if (!last) {
+        while (end > start && buffer[end - 1] != '\n') {
+            end--;
+        }
+
+        AsyncReader_Append(carry, buffer + end, size - end);
+    }
+
+    if (end == start) {
+        return true;
+    }
+
+    buffer[end] = '\0';
+
+    return callback((Slice){buffer + start, end - start}, context);
+}
+
+typedef struct AsyncReaderRing {
+    int fd;
+
+    void *sq_ring;
+    void *cq_ring;
+    struct io_uring_sqe *sqes;
+    u64 sq_ring_size;
+    u64 cq_ring_size;
+    u64 sqes_size;
+
+    u32 *sq_head;
+    u32 *sq_tail;
+    u32 *sq_mask;
+    u32 *sq_array;
+
+    u32 *cq_head;
+    u32 *cq_tail;
+    u32 *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    u32 pending;
+} AsyncReaderRing;
+
+typedef struct AsyncReaderBuffer {
+    char *data;
+    u64 offset;
+    u64 length;
+    u64 filled;
+    bool busy;
+    bool eof;
+} AsyncReaderBuffer;
+
+static bool
+AsyncReader_Setup(AsyncReaderRing *ring, u32 entries)
+{
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(*ring));
+
+    long fd = syscall(__NR_io_uring_setup, entries, &params);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    ring->fd = (int) fd;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) {
+            ring->sq_ring_size = ring->cq_ring_size;
+        }
+
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+
+    if (ring->sq_ring == MAP_FAILED) {
+        goto setup_error;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+
+        if (ring->cq_ring == MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+
+            goto setup_error;
+        }
+    }
+
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cq_ring != ring->sq_ring) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+
+        munmap(ring->sq_ring, ring->sq_ring_size);
+
+        goto setup_error;
+    }
+
+    u8 *sq = ring->sq_ring;
+    u8 *cq = ring->cq_ring;
+
+    ring->sq_head = (u32 *) (void *) (sq + params.sq_off.head);
+    ring->sq_tail = (u32 *) (void *) (sq + params.sq_off.tail);
+    ring->sq_mask = (u32 *) (void *) (sq + params.sq_off.ring_mask);
+    ring->sq_array = (u32 *) (void *) (sq + params.sq_off.array);
+
+    ring->cq_head = (u32 *) (void *) (cq + params.cq_off.head);
+    ring->cq_tail = (u32 *) (void *) (cq + params.cq_off.tail);
+    ring->cq_mask = (u32 *) (void *) (cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (void *) (cq + params.cq_off.cqes);
+
+    return true;
+
+setup_error:
+    close(ring->fd);
+
+    return false;
+}
+
+static void
+AsyncReader_Teardown(AsyncReaderRing *ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+static void
+AsyncReader_Submit(AsyncReaderRing *ring, int fd, AsyncReaderBuffer *buffer, u64 index)
+{
+    u32 tail = *ring->sq_tail;
+    u32 slot = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[slot];
+
+    memset(sqe, 0, sizeof(*sqe));
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (u64) (uintptr_t) (buffer->data + buffer->filled);
+    sqe->len = (buffer->length - buffer->filled > UINT32_MAX) ? UINT32_MAX : (u32) (buffer->length - buffer->filled);
+    sqe->off = buffer->offset + buffer->filled;
+    sqe->user_data = index;
+
+    ring->sq_array[slot] = slot;
+
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    if (syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) < 0) {
+        Quit(-1, "%s: can't submit read (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+    }
+
+    buffer->busy = true;
+    ring->pending++;
+}
+
+// Returns false if the kernel rejected a read as unsupported, an
+// io_uring without IORING_OP_READ or a file that can't be read through it.
+static bool
+AsyncReader_Reap(AsyncReaderRing *ring, int fd, AsyncReaderBuffer *buffers)
+{
+    u32 head = *ring->cq_head;
+    bool supported = true;
+
+    while (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+            Quit(-1, "%s: can't wait for read (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+        }
+    }
+
+    while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        u64 index = cqe->user_data;
+        i32 result = cqe->res;
+
+        head++;
+
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        AsyncReaderBuffer *buffer = &buffers[index];
+
+        buffer->busy = false;
+        ring->pending--;
+
+        if (result == -EINTR || result == -EAGAIN) {
+            AsyncReader_Submit(ring, fd, buffer, index);
+        } else if (result == -EINVAL || result == -EOPNOTSUPP) {
+            buffer->length = 0;
+            supported = false;
+        } else if (result < 0) {
+            Quit(-1, "%s: can't read input (%s) in %s at line %d.", __FILE__, strerror(-result), __func__, __LINE__);
+        } else if (result == 0) {
+            // The file shrank after fstat, this chunk ends the input.
+            buffer->length = buffer->filled;
+            buffer->eof = true;
+        } else {
+            buffer->filled += (u64) result;
+
+            if (buffer->filled < buffer->length) {
+                AsyncReader_Submit(ring, fd, buffer, index);
+            }
+        }
+    }
+
+    return supported;
+}
+
+// Reads from the fd's current position to file_size, leaving the position
+// after the last byte read like plain reads would.
+static bool
+AsyncReader_ReadRing(int fd, u64 file_size, AsyncReaderConfig config, AsyncReaderCallback callback, void *context, u64 *total)
+{
+    off_t position = lseek(fd, 0, SEEK_CUR);
+
+    if (position < 0) {
+        return false;
+    }
+
+    AsyncReaderRing ring;
+
+    if (!AsyncReader_Setup(&ring, config.depth)) {
+        return false;
+    }
+
+    AsyncReaderBuffer *buffers = calloc(config.depth, sizeof(AsyncReaderBuffer));
+
+    if (buffers == NULL) {
+        goto out_of_memory;
+    }
+
+    for (u32 i = 0; i < config.depth; ++i) {
+        buffers[i].data = malloc(config.chunk_size + 1);
+
+        if (buffers[i].data == NULL) {
+            goto out_of_memory;
+        }
+    }
+
+    AsyncReaderCarry carry = {NULL, 0, 0};
+    u64 next_offset = (u64) position;
+    u64 sequence = 0;
+    bool running = true;
+    bool supported = true;
+    bool finished = false;
+
+    for (u32 i = 0; i < config.depth && next_offset < file_size; ++i) {
+        buffers[i].offset = next_offset;
+        buffers[i].length = (file_size - next_offset < config.chunk_size) ? file_size - next_offset : config.chunk_size;
+        buffers[i].filled = 0;
+        buffers[i].eof = false;
+
+        next_offset += buffers[i].length;
+
+        AsyncReader_Submit(&ring, fd, &buffers[i], i);
+    }
+
+    // Chunks complete in any order but are delivered by sequence, the
+    // buffer holding the lowest file offset still to be processed.
+    while (running && !finished && ring.pending > 0) {
+        if (!AsyncReader_Reap(&ring, fd, buffers)) {
+            supported = false;
+            break;
+        }
+
+        while (running && !finished) {
+            u64 index = sequence % config.depth;
+            AsyncReaderBuffer *buffer = &buffers[index];
+
+            if (buffer->busy || (buffer->length == 0 && !buffer->eof) || buffer->filled < buffer->length) {
+                break;
+            }
+
+            bool last = buffer->eof || buffer->offset + buffer->length >= file_size;
+
+            *total += buffer->filled;
+
+            running = AsyncReader_Deliver(buffer->data, buffer->filled, last, &carry, callback, context);
+
+            buffer->length = 0;
+            sequence++;
+            finished = last;
+
+            if (running && next_offset < file_size && !last) {
+                buffer->offset = next_offset;
+                buffer->length = (file_size - next_offset < config.chunk_size) ? file_size - next_offset : config.chunk_size;
+                buffer->filled = 0;
+                buffer->eof = false;
+
+                next_offset += buffer->length;
+
+                AsyncReader_Submit(&ring, fd, buffer, index);
+            }
+        }
+    }
+
+    while (ring.pending > 0) {
+        AsyncReader_Reap(&ring, fd, buffers);
+    }
+
+    for (u32 i = 0; i < config.depth; ++i) {
+        free(buffers[i].data);
+    }
+
+    free(buffers);
+    free(carry.data);
+
+    AsyncReader_Teardown(&ring);
+
+    // Ring reads use explicit offsets and leave the file position alone,
+    // so the caller can start over with plain reads as long as nothing
+    // was handed to the callback yet.
+    if (!supported) {
+        if (sequence > 0) {
+            Quit(-1, "%s: can't read input (%s) in %s at line %d.", __FILE__, strerror(EOPNOTSUPP), __func__, __LINE__);
+        }
+
+        *total = 0;
+
+        return false;
+    }
+
+    lseek(fd, position + (off_t) *total, SEEK_SET);
+
+    return true;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+#endif
+
+static u64
+AsyncReader_ReadSync(int fd, AsyncReaderConfig config, AsyncReaderCallback callback, void *context)
+{
+    SliceReader *reader = NULL;
+    u64 total = 0;
+
+    SliceReader_Attach(&reader, fd, config.chunk_size);
+
+    while (1) {
+        Slice chunk = SliceReader_Next(reader);
+
+        if (chunk.data == NULL) {
+            break;
+        }
+
+        total += chunk.size;
+
+        if (!callback(chunk, context)) {
+            break;
+        }
+    }
+
+    SliceReader_Close(&reader);
+
+    return total;
+}
+
+static u64
+AsyncReader_Read(int fd, AsyncReaderConfig config, AsyncReaderCallback callback, void *context)
+{
+    if (config.chunk_size == 0) {
+        config.chunk_size = ASYNC_READER_CHUNK_SIZE;
+    }
+
+    if (config.depth == 0) {
+        config.depth = ASYNC_READER_DEPTH;
+    }
+
+#if defined(LIB_C_IO_URING)
+    struct stat info;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        u64 total = 0;
+
+        if (AsyncReader_ReadRing(fd, (u64) info.st_size, config, callback, context, &total)) {
+            return total;
+        }
+    }
+#endif
+
+    return AsyncReader_ReadSync(fd, config, callback, context);
+}
+
+u64
+AsyncReader_ReadFile(const char *path, AsyncReaderConfig config, AsyncReaderCallback callback, void *context)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        Quit(-1, "%s: can't open '%s' (%s).", __FILE__, path, strerror(errno));
+    }
+
+    u64 total = AsyncReader_Read(fd, config, callback, context);
+
+    close(fd);
+
+    return total;
+}
+
+u64
+AsyncReader_ReadStdIn(AsyncReaderConfig config, AsyncReaderCallback callback, void *context)
+{
+    return AsyncReader_Read(STDIN_FILENO, config, callback, context);
+}
@@ -0,0 +1,21 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef ASYNC_READER_H
+#define ASYNC_READER_H 1
+
+// The chunk handed to the callback holds whole lines and is only valid
+// until the callback returns. Returning false stops the read.
+typedef bool (*AsyncReaderCallback)(Slice chunk, void *context);
+
+typedef struct AsyncReaderConfig {
+    u64 chunk_size;
+    u32 depth;
+} AsyncReaderConfig;
+
+u64 AsyncReader_ReadFile(const char *path, AsyncReaderConfig config, AsyncReaderCallback callback, void *context);
+// Reads stdin from its current position, so input already consumed by other
+// reads isn't delivered again.
+u64 AsyncReader_ReadStdIn(AsyncReaderConfig config, AsyncReaderCallback callback, void *context);
+
+#endif // ASYNC_READER_H
@@ -1,22 +1,360 @@
 // Copyright (c) 2022 Gustavo Ribeiro Croscato
 // SPDX-License-Identifier: MIT
 
-#include "binary_tree.h"
+#define BINARY_TREE_SLAB_NODES 256
+#define BINARY_TREE_ALIGN(size) (((size) + 7) & ~(u64) 7)
 
-typedef struct BinaryTreeNode {
+struct BinaryTreeNode {
     struct BinaryTreeNode *left;
     struct BinaryTreeNode *right;
+    i64 height;
     u8 value[];
-} BinaryTreeNode;
+};
 
 struct BinaryTree {
     BinaryTreeNode *root;
+    u64 count;
+
+    u64 key_size;
+    u64 value_size;
+    u64 value_offset;
+
+    BinaryTreeCompare compare;
+
+    Pool *nodes;
 };
 
+static int
+BinaryTree_Compare(const BinaryTree *tree, const void *left, const void *right)
+{
+    if (tree->compare != NULL) {
+        return tree->compare(left, right);
+    }
+
+    return memcmp(left, right, tree->key_size);
+}
+
+// Keys live in byte arrays inside the nodes, so they're copied out instead of
+// dereferenced in place.
+int
+BinaryTree_CompareU64(const void *key1, const void *key2)
+{
+    u64 left;
+    u64 right;
+
+    memcpy(&left, key1, sizeof(left));
+    memcpy(&right, key2, sizeof(right));
+
+    return (left > right) - (left < right);
+}
+
+int
+BinaryTree_CompareI64(const void *key1, const void *key2)
+{
+    i64 left;
+    i64 right;
+
+    memcpy(&left, key1, sizeof(left));
+    memcpy(&right, key2, sizeof(right));
+
+    return (left > right) - (left < right);
+}
+
+static inline i64
+BinaryTree_Height(const BinaryTreeNode *node)
+{
+    return node == NULL ? 0 : node->height;
+}
+
+static inline void
+BinaryTree_Update(BinaryTreeNode *node)
+{
+    i64 left = BinaryTree_Height(node->left);
+    i64 right = BinaryTree_Height(node->right);
+
+    node->height = (left > right ? left : right) + 1;
+}
+
+static BinaryTreeNode *
+BinaryTree_RotateRight(BinaryTreeNode *node)
+{
+    BinaryTreeNode *pivot = node->left;
+
+    node->left = pivot->right;
+    pivot->right = node;
+
+    BinaryTree_Update(node);
+    BinaryTree_Update(pivot);
+
+    return pivot;
+}
+
+static BinaryTreeNode *
+BinaryTree_RotateLeft(BinaryTreeNode *node)
+{
+    BinaryTreeNode *pivot = node->right;
+
+    node->right = pivot->left;
+    pivot->left = node;
+
+    BinaryTree_Update(node);
+    BinaryTree_Update(pivot);
+
+    return pivot;
+}
+
+static BinaryTreeNode *
+BinaryTree_Balance(BinaryTreeNode *node)
+{
+    BinaryTree_Update(node);
+
+    i64 balance = BinaryTree_Height(node->left) - BinaryTree_Height(node->right);
+
+    if (balance > 1) {
+        if (BinaryTree_Height(node->left->left) < BinaryTree_Height(node->left->right)) {
+            node->left = BinaryTree_RotateLeft(node->left);
+        }
+
+        return BinaryTree_RotateRight(node);
+    }
+
+    if (balance < -1) {
+        if (BinaryTree_Height(node->right->right) < BinaryTree_Height(node->right->left)) {
+            node->right = BinaryTree_RotateRight(node->right);
+        }
+
+        return BinaryTree_RotateLeft(node);
+    }
+
+    return node;
+}
+
+static BinaryTreeNode *
+BinaryTree_InsertNode(BinaryTree *tree, BinaryTreeNode *node, const void *key, BinaryTreeNode **result)
+{
+    if (node == NULL) {
+        node = Pool_Alloc(tree->nodes);
+
+        node->left = NULL;
+        node->right = NULL;
+        node->height = 1;
+
+        memcpy(node->value, key, tree->key_size);
+        memset(node->value + tree->value_offset, 0, tree->value_size);
+
+        tree->count++;
+
+        *result = node;
+
+        return node;
+    }
+
+    int order = BinaryTree_Compare(tree, key, node->value);
+
+    if (order == 0) {
+        *result = node;
+
+        return node;
+    }
+
+    if (order < 0) {
+        node->left = BinaryTree_InsertNode(tree, node->left, key, result);
+    } else {
+        node->right = BinaryTree_InsertNode(tree, node->right, key, result);
+    }
+
+    return BinaryTree_Balance(node);
+}
+
+static BinaryTreeNode *
+BinaryTree_RemoveMin(BinaryTreeNode *node, BinaryTreeNode **min)
+{
+    if (node->left == NULL) {
+        *min = node;
+
+        return node->right;
+    }
+
+    node->left = BinaryTree_RemoveMin(node->left, min);
+
+    return BinaryTree_Balance(node);
+}
+
+static BinaryTreeNode *
+BinaryTree_EraseNode(BinaryTree *tree, BinaryTreeNode *node, const void *key, bool *erased)
+{
+    if (node == NULL) {
+        return NULL;
+    }
+
+    int order = BinaryTree_Compare(tree, key, node->value);
+
+    if (order < 0) {
+        node->left = BinaryTree_EraseNode(tree, node->left, key, erased);
+    } else if (order > 0) {
+        node->right = BinaryTree_EraseNode(tree, node->right, key, erased);
+    } else {
+        BinaryTreeNode *left = node->left;
+        BinaryTreeNode *right = node->right;
+
+        Pool_Free(tree->nodes, node);
+
+        tree->count--;
+        *erased = true;
+
+        if (right == NULL) {
+            return left;
+        }
+
+        // The successor node takes the erased node's place, so the other
+        // entries keep their addresses.
+        BinaryTreeNode *successor;
+
+        right = BinaryTree_RemoveMin(right, &successor);
+
+        successor->left = left;
+        successor->right = right;
+
+        return BinaryTree_Balance(successor);
+    }
+
+    return BinaryTree_Balance(node);
+}
+
 void
 BinaryTree_Create(BinaryTree **tree, BinaryTreeConfig config)
 {
-    UNUSED(tree);
-    UNUSED(config);
+    *tree = malloc(sizeof(BinaryTree));
+
+    if (*tree == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    (*tree)->root = NULL;
+    (*tree)->count = 0;
+    (*tree)->key_size = config.key_size;
+    (*tree)->value_size = config.value_size;
+    (*tree)->value_offset = BINARY_TREE_ALIGN(config.key_size);
+    (*tree)->compare = config.compare;
+
+    Pool_Create(&(*tree)->nodes, (PoolConfig) {
+        .object_size = sizeof(BinaryTreeNode) + BINARY_TREE_ALIGN(config.key_size) + BINARY_TREE_ALIGN(config.value_size),
+        .slab_objects = BINARY_TREE_SLAB_NODES,
+    });
+}
+
+void
+BinaryTree_Destroy(BinaryTree **tree)
+{
+    if (tree == NULL || *tree == NULL) {
+        return;
+    }
+
+    Pool_Destroy(&(*tree)->nodes);
+
+    free(*tree);
+
+    *tree = NULL;
+}
+
+u64
+BinaryTree_Count(const BinaryTree *tree)
+{
+    return tree->count;
+}
+
+void *
+BinaryTree_Find(const BinaryTree *tree, const void *key)
+{
+    BinaryTreeNode *node = tree->root;
+
+    while (node != NULL) {
+        int order = BinaryTree_Compare(tree, key, node->value);
+
+        if (order == 0) {
+            return node->value + tree->value_offset;
+        }
+
+        node = order < 0 ? node->left : node->right;
+    }
+
+    return NULL;
 }
 
+void *
+BinaryTree_Upsert(BinaryTree *tree, const void *key, bool *inserted)
+{
+    u64 count = tree->count;
+
+    BinaryTreeNode *node;
+
+    tree->root = BinaryTree_InsertNode(tree, tree->root, key, &node);
+
+    if (inserted != NULL) {
+        *inserted = tree->count != count;
+    }
+
+    return node->value + tree->value_offset;
+}
+
+bool
+BinaryTree_Insert(BinaryTree *tree, const void *key, const void *value)
+{
+    bool inserted;
+    void *slot = BinaryTree_Upsert(tree, key, &inserted);
+
+    if (inserted && value != NULL) {
+        memcpy(slot, value, tree->value_size);
+    }
+
+    return inserted;
+}
+
+bool
+BinaryTree_Erase(BinaryTree *tree, const void *key)
+{
+    bool erased = false;
+
+    tree->root = BinaryTree_EraseNode(tree, tree->root, key, &erased);
+
+    return erased;
+}
+
+static void
+BinaryTreeIterator_PushLeft(BinaryTreeIterator *iterator, BinaryTreeNode *node)
+{
+    while (node != NULL) {
+        iterator->stack[iterator->depth++] = node;
+        node = node->left;
+    }
+}
+
+BinaryTreeIterator
+BinaryTree_Iterate(const BinaryTree *tree)
+{
+    BinaryTreeIterator iterator;
+
+    iterator.depth = 0;
+    iterator.value_offset = tree->value_offset;
+
+    BinaryTreeIterator_PushLeft(&iterator, tree->root);
+
+    return iterator;
+}
+
+bool
+BinaryTreeIterator_Next(BinaryTreeIterator *iterator, BinaryTreeEntry *entry)
+{
+    if (iterator->depth == 0) {
+        return false;
+    }
+
+    BinaryTreeNode *node = iterator->stack[--iterator->depth];
+
+    BinaryTreeIterator_PushLeft(iterator, node->right);
+
+    entry->key = node->value;
+    entry->value = node->value + iterator->value_offset;
+
+    return true;
+}
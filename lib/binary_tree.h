@@ -4,13 +4,52 @@
 #ifndef BINARY_TREE_H
 #define BINARY_TREE_H 1
 
+// An AVL tree never gets taller than 1.44 log2(n), this covers any u64 count.
+#define BINARY_TREE_MAX_HEIGHT 96
+
 typedef struct BinaryTree BinaryTree;
+typedef struct BinaryTreeNode BinaryTreeNode;
+
+typedef int (*BinaryTreeCompare)(const void *key1, const void *key2);
 
+// Keys and values are copied into the nodes. A NULL compare orders keys by
+// memcmp over key_size bytes, which suits strings and byte arrays but not
+// integers: on little-endian machines 256 sorts before 1. Integer keys should
+// use one of the typed comparators below.
 typedef struct BinaryTreeConfig {
+    u64 key_size;
     u64 value_size;
+
+    BinaryTreeCompare compare;
 } BinaryTreeConfig;
 
+typedef struct BinaryTreeEntry {
+    const void *key;
+    void *value;
+} BinaryTreeEntry;
+
+typedef struct BinaryTreeIterator {
+    BinaryTreeNode *stack[BINARY_TREE_MAX_HEIGHT];
+    u64 depth;
+    u64 value_offset;
+} BinaryTreeIterator;
+
+int BinaryTree_CompareU64(const void *key1, const void *key2);
+int BinaryTree_CompareI64(const void *key1, const void *key2);
+
 void BinaryTree_Create(BinaryTree **tree, BinaryTreeConfig config);
+void BinaryTree_Destroy(BinaryTree **tree);
+u64 BinaryTree_Count(const BinaryTree *tree);
 
-#endif // BINARY_TREE_H
+// Value pointers stay valid until their own key is erased.
+void *BinaryTree_Find(const BinaryTree *tree, const void *key);
+void *BinaryTree_Upsert(BinaryTree *tree, const void *key, bool *inserted);
+bool BinaryTree_Insert(BinaryTree *tree, const void *key, const void *value);
+bool BinaryTree_Erase(BinaryTree *tree, const void *key);
 
+// Visits the entries in ascending key order. The tree must not change while
+// an iterator is in use.
+BinaryTreeIterator BinaryTree_Iterate(const BinaryTree *tree);
+bool BinaryTreeIterator_Next(BinaryTreeIterator *iterator, BinaryTreeEntry *entry);
+
+#endif // BINARY_TREE_H
@@ -0,0 +1,270 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+#define BITSET_WORD_BITS 64
+#define BITSET_WORDS(size) (((size) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+struct Bitset {
+    u64 *words;
+    u64 size;
+    u64 count;
+};
+
+typedef enum BitsetOperation {
+      BITSET_SET
+    , BITSET_CLEAR
+    , BITSET_FLIP
+} BitsetOperation;
+
+static inline void
+Bitset_ApplyWord(u64 *word, u64 mask, BitsetOperation operation)
+{
+    if (operation == BITSET_SET) {
+        *word |= mask;
+    } else if (operation == BITSET_CLEAR) {
+        *word &= ~mask;
+    } else {
+        *word ^= mask;
+    }
+}
+
+// Applies an operation to every bit of a run of whole words. Set and clear
+// are plain stores, so only flip has to read the words.
+static inline void
+Bitset_ApplyWords(u64 *words, u64 count, BitsetOperation operation)
+{
+    u64 i = 0;
+
+#if defined(__AVX2__)
+    if (operation == BITSET_FLIP) {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+
+        for (; i + 4 <= count; i += 4) {
+            __m256i *block = (__m256i *) (void *) (words + i);
+
+            _mm256_storeu_si256(block, _mm256_xor_si256(_mm256_loadu_si256(block), ones));
+        }
+    } else {
+        const __m256i fill = operation == BITSET_SET ? _mm256_set1_epi64x(-1) : _mm256_setzero_si256();
+
+        for (; i + 4 <= count; i += 4) {
+            _mm256_storeu_si256((__m256i *) (void *) (words + i), fill);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        Bitset_ApplyWord(&words[i], ~(u64) 0, operation);
+    }
+}
+
+static void
+Bitset_ApplyRange(Bitset *set, u64 first, u64 last, BitsetOperation operation)
+{
+    if (first >= last) {
+        return;
+    }
+
+    if (last > set->size) {
+        Quit(-1, "%s: range [%" PRIu64 ", %" PRIu64 ") out of bounds in %s.", __FILE__, first, last, __func__);
+    }
+
+    u64 first_word = first / BITSET_WORD_BITS;
+    u64 last_word = (last - 1) / BITSET_WORD_BITS;
+    u64 first_mask = ~(u64) 0 << (first % BITSET_WORD_BITS);
+    u64 last_mask = ~(u64) 0 >> (BITSET_WORD_BITS - 1 - (last - 1) % BITSET_WORD_BITS);
+
+    if (first_word == last_word) {
+        Bitset_ApplyWord(&set->words[first_word], first_mask & last_mask, operation);
+
+        return;
+    }
+
+    Bitset_ApplyWord(&set->words[first_word], first_mask, operation);
+    Bitset_ApplyWords(set->words + first_word + 1, last_word - first_word - 1, operation);
+    Bitset_ApplyWord(&set->words[last_word], last_mask, operation);
+}
+
+#if defined(__AVX2__)
+// Population count of four words at a time with a nibble lookup table.
+static inline __m256i
+Bitset_Popcount256(__m256i value)
+{
+    const __m256i table = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+    __m256i low = _mm256_and_si256(value, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high));
+
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+#endif
+
+void
+Bitset_Create(Bitset **set, u64 size)
+{
+    *set = malloc(sizeof(Bitset));
+
+    if (*set == NULL) {
+        goto out_of_memory;
+    }
+
+    (*set)->count = BITSET_WORDS(size);
+    (*set)->size = size;
+    (*set)->words = calloc((*set)->count > 0 ? (*set)->count : 1, sizeof(u64));
+
+    if ((*set)->words == NULL) {
+        goto out_of_memory;
+    }
+
+    return;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+void
+Bitset_Destroy(Bitset **set)
+{
+    if (set == NULL || *set == NULL) {
+        return;
+    }
+
+    free((*set)->words);
+    free(*set);
+
+    *set = NULL;
+}
+
+u64
+Bitset_Size(const Bitset *set)
+{
+    return set->size;
+}
+
+bool
+Bitset_Test(const Bitset *set, u64 index)
+{
+    return (set->words[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+void
+Bitset_Set(Bitset *set, u64 index)
+{
+    set->words[index / BITSET_WORD_BITS] |= (u64) 1 << (index % BITSET_WORD_BITS);
+}
+
+void
+Bitset_Clear(Bitset *set, u64 index)
+{
+    set->words[index / BITSET_WORD_BITS] &= ~((u64) 1 << (index % BITSET_WORD_BITS));
+}
+
+void
+Bitset_Flip(Bitset *set, u64 index)
+{
+    set->words[index / BITSET_WORD_BITS] ^= (u64) 1 << (index % BITSET_WORD_BITS);
+}
+
+void
+Bitset_SetRange(Bitset *set, u64 first, u64 last)
+{
+    Bitset_ApplyRange(set, first, last, BITSET_SET);
+}
+
+void
+Bitset_ClearRange(Bitset *set, u64 first, u64 last)
+{
+    Bitset_ApplyRange(set, first, last, BITSET_CLEAR);
+}
+
+void
+Bitset_FlipRange(Bitset *set, u64 first, u64 last)
+{
+    Bitset_ApplyRange(set, first, last, BITSET_FLIP);
+}
+
+u64
+Bitset_Count(const Bitset *set)
+{
+    u64 count = 0;
+    u64 i = 0;
+
+#if defined(__AVX2__)
+    __m256i total = _mm256_setzero_si256();
+
+    for (; i + 4 <= set->count; i += 4) {
+        __m256i words = _mm256_loadu_si256((const __m256i *) (const void *) (set->words + i));
+
+        total = _mm256_add_epi64(total, Bitset_Popcount256(words));
+    }
+
+    u64 lanes[4];
+
+    _mm256_storeu_si256((__m256i *) (void *) lanes, total);
+
+    count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < set->count; ++i) {
+        count += (u64) __builtin_popcountll(set->words[i]);
+    }
+
+    return count;
+}
+
+static void
+Bitset_CheckSizes(const Bitset *target, const Bitset *source, const char *function)
+{
+    if (target->size != source->size) {
+        Quit(-1, "%s: size mismatch (%" PRIu64 " and %" PRIu64 ") in %s.", __FILE__, target->size, source->size, function);
+    }
+}
+
+void
+Bitset_And(Bitset *target, const Bitset *source)
+{
+    Bitset_CheckSizes(target, source, __func__);
+
+    for (u64 i = 0; i < target->count; ++i) {
+        target->words[i] &= source->words[i];
+    }
+}
+
+void
+Bitset_Or(Bitset *target, const Bitset *source)
+{
+    Bitset_CheckSizes(target, source, __func__);
+
+    for (u64 i = 0; i < target->count; ++i) {
+        target->words[i] |= source->words[i];
+    }
+}
+
+void
+Bitset_Xor(Bitset *target, const Bitset *source)
+{
+    Bitset_CheckSizes(target, source, __func__);
+
+    for (u64 i = 0; i < target->count; ++i) {
+        target->words[i] ^= source->words[i];
+    }
+}
+
+void
+Bitset_AndNot(Bitset *target, const Bitset *source)
+{
+    Bitset_CheckSizes(target, source, __func__);
+
+    for (u64 i = 0; i < target->count; ++i) {
+        target->words[i] &= ~source->words[i];
+    }
+}
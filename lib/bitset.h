@@ -0,0 +1,33 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef BITSET_H
+#define BITSET_H 1
+
+// Fixed-size set of bits stored in u64 words. Ranges are half open,
+// [first, last). Only their edge words are masked, the words in between are
+// written whole, four at a time when built with AVX2.
+typedef struct Bitset Bitset;
+
+void Bitset_Create(Bitset **set, u64 size);
+void Bitset_Destroy(Bitset **set);
+u64 Bitset_Size(const Bitset *set);
+
+bool Bitset_Test(const Bitset *set, u64 index);
+void Bitset_Set(Bitset *set, u64 index);
+void Bitset_Clear(Bitset *set, u64 index);
+void Bitset_Flip(Bitset *set, u64 index);
+
+void Bitset_SetRange(Bitset *set, u64 first, u64 last);
+void Bitset_ClearRange(Bitset *set, u64 first, u64 last);
+void Bitset_FlipRange(Bitset *set, u64 first, u64 last);
+
+u64 Bitset_Count(const Bitset *set);
+
+// Combine two sets of the same size into target.
+void Bitset_And(Bitset *target, const Bitset *source);
+void Bitset_Or(Bitset *target, const Bitset *source);
+void Bitset_Xor(Bitset *target, const Bitset *source);
+void Bitset_AndNot(Bitset *target, const Bitset *source);
+
+#endif // BITSET_H
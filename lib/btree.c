@@ -0,0 +1,408 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+// B+tree: inner nodes only route, every key and value lives in a leaf and the
+// leaves are linked in key order for range scans. Keys are stored with the
+// sign bit flipped so the signed 64-bit SIMD compare orders them as unsigned.
+// Full nodes are split on the way down, so an insert never walks back up.
+// Erase does not merge nodes, emptied leaves stay linked and are skipped.
+#define BTREE_NODE_ALIGNMENT 64
+#define BTREE_ALIGN(size) (((size) + 7) & ~(u64) 7)
+#define BTREE_BIAS(key) ((i64) ((key) ^ 0x8000000000000000ULL))
+#define BTREE_UNBIAS(key) ((u64) (key) ^ 0x8000000000000000ULL)
+
+typedef struct BTreeNode {
+    u32 count;
+    bool leaf;
+    i64 keys[BTREE_KEYS];
+} BTreeNode;
+
+typedef struct BTreeInner {
+    BTreeNode node;
+    BTreeNode *children[BTREE_KEYS + 1];
+} BTreeInner;
+
+struct BTreeLeaf {
+    BTreeNode node;
+    struct BTreeLeaf *next;
+    u8 values[];
+};
+
+struct BTree {
+    BTreeNode *root;
+    BTreeLeaf *first;
+    u64 count;
+
+    u64 value_size;
+    u64 leaf_size;
+};
+
+// Number of keys smaller than key.
+static u32
+BTree_Rank(const BTreeNode *node, i64 key)
+{
+    u32 rank = 0;
+    u32 i = 0;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi64x(key);
+
+    for (; i + 4 <= node->count; i += 4) {
+        __m256i keys = _mm256_loadu_si256((const __m256i *) (const void *) (node->keys + i));
+        __m256i less = _mm256_cmpgt_epi64(needle, keys);
+
+        rank += (u32) __builtin_popcount((u32) _mm256_movemask_pd(_mm256_castsi256_pd(less)));
+    }
+#endif
+
+    for (; i < node->count; ++i) {
+        rank += node->keys[i] < key;
+    }
+
+    return rank;
+}
+
+// Index of the child whose range holds key.
+static inline u32
+BTree_Route(const BTreeNode *node, i64 key)
+{
+    u32 index = BTree_Rank(node, key);
+
+    if (index < node->count && node->keys[index] == key) {
+        index++;
+    }
+
+    return index;
+}
+
+static inline u8 *
+BTree_Value(const BTree *tree, const BTreeLeaf *leaf, u64 index)
+{
+    return (u8 *) (uintptr_t) leaf->values + index * BTREE_ALIGN(tree->value_size);
+}
+
+static void *
+BTree_AllocateNode(u64 size)
+{
+    size = (size + BTREE_NODE_ALIGNMENT - 1) & ~(u64) (BTREE_NODE_ALIGNMENT - 1);
+
+    void *node = aligned_alloc(BTREE_NODE_ALIGNMENT, size);
+
+    if (node == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    return node;
+}
+
+static BTreeLeaf *
+BTree_CreateLeaf(const BTree *tree)
+{
+    BTreeLeaf *leaf = BTree_AllocateNode(tree->leaf_size);
+
+    leaf->node.count = 0;
+    leaf->node.leaf = true;
+    leaf->next = NULL;
+
+    return leaf;
+}
+
+static BTreeInner *
+BTree_CreateInner(void)
+{
+    BTreeInner *inner = BTree_AllocateNode(sizeof(BTreeInner));
+
+    inner->node.count = 0;
+    inner->node.leaf = false;
+
+    return inner;
+}
+
+static void
+BTree_DestroyNode(BTreeNode *node)
+{
+    if (!node->leaf) {
+        BTreeInner *inner = (BTreeInner *) node;
+
+        for (u32 i = 0; i <= node->count; ++i) {
+            BTree_DestroyNode(inner->children[i]);
+        }
+    }
+
+    free(node);
+}
+
+// Splits the full child at index of parent in two halves and adds the
+// separator to parent, which must have room for it.
+static void
+BTree_SplitChild(BTree *tree, BTreeInner *parent, u32 index)
+{
+    BTreeNode *child = parent->children[index];
+    BTreeNode *right;
+    i64 separator;
+
+    if (child->leaf) {
+        BTreeLeaf *left_leaf = (BTreeLeaf *) child;
+        BTreeLeaf *right_leaf = BTree_CreateLeaf(tree);
+        u32 half = child->count / 2;
+        u32 moved = child->count - half;
+
+        memcpy(right_leaf->node.keys, child->keys + half, sizeof(i64) * moved);
+        memcpy(
+            right_leaf->values,
+            BTree_Value(tree, left_leaf, half),
+            BTREE_ALIGN(tree->value_size) * moved
+        );
+
+        right_leaf->node.count = moved;
+        right_leaf->next = left_leaf->next;
+        left_leaf->next = right_leaf;
+        child->count = half;
+
+        right = &right_leaf->node;
+        separator = right->keys[0];
+    } else {
+        BTreeInner *left_inner = (BTreeInner *) child;
+        BTreeInner *right_inner = BTree_CreateInner();
+        u32 half = child->count / 2;
+        u32 moved = child->count - half - 1;
+
+        memcpy(right_inner->node.keys, child->keys + half + 1, sizeof(i64) * moved);
+        memcpy(right_inner->children, left_inner->children + half + 1, sizeof(BTreeNode *) * (moved + 1));
+
+        right_inner->node.count = moved;
+        child->count = half;
+
+        right = &right_inner->node;
+        separator = child->keys[half];
+    }
+
+    BTreeNode *node = &parent->node;
+
+    memmove(node->keys + index + 1, node->keys + index, sizeof(i64) * (node->count - index));
+    memmove(parent->children + index + 2, parent->children + index + 1, sizeof(BTreeNode *) * (node->count - index));
+
+    node->keys[index] = separator;
+    parent->children[index + 1] = right;
+    node->count++;
+}
+
+static const BTreeLeaf *
+BTree_FindLeaf(const BTree *tree, i64 key)
+{
+    const BTreeNode *node = tree->root;
+
+    while (!node->leaf) {
+        node = ((const BTreeInner *) (const void *) node)->children[BTree_Route(node, key)];
+    }
+
+    return (const BTreeLeaf *) (const void *) node;
+}
+
+void
+BTree_Create(BTree **tree, BTreeConfig config)
+{
+    *tree = malloc(sizeof(BTree));
+
+    if (*tree == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    (*tree)->count = 0;
+    (*tree)->value_size = config.value_size;
+    (*tree)->leaf_size = sizeof(BTreeLeaf) + BTREE_ALIGN(config.value_size) * BTREE_KEYS;
+
+    BTreeLeaf *leaf = BTree_CreateLeaf(*tree);
+
+    (*tree)->root = &leaf->node;
+    (*tree)->first = leaf;
+}
+
+void
+BTree_Destroy(BTree **tree)
+{
+    if (tree == NULL || *tree == NULL) {
+        return;
+    }
+
+    BTree_DestroyNode((*tree)->root);
+
+    free(*tree);
+
+    *tree = NULL;
+}
+
+u64
+BTree_Count(const BTree *tree)
+{
+    return tree->count;
+}
+
+void *
+BTree_Find(const BTree *tree, u64 key)
+{
+    i64 biased = BTREE_BIAS(key);
+
+    const BTreeLeaf *leaf = BTree_FindLeaf(tree, biased);
+    u32 index = BTree_Rank(&leaf->node, biased);
+
+    if (index == leaf->node.count || leaf->node.keys[index] != biased) {
+        return NULL;
+    }
+
+    return BTree_Value(tree, leaf, index);
+}
+
+void *
+BTree_Upsert(BTree *tree, u64 key, bool *inserted)
+{
+    i64 biased = BTREE_BIAS(key);
+
+    if (tree->root->count == BTREE_KEYS) {
+        BTreeInner *root = BTree_CreateInner();
+
+        root->children[0] = tree->root;
+        tree->root = &root->node;
+
+        BTree_SplitChild(tree, root, 0);
+    }
+
+    BTreeNode *node = tree->root;
+
+    while (!node->leaf) {
+        BTreeInner *inner = (BTreeInner *) node;
+        u32 index = BTree_Route(node, biased);
+
+        if (inner->children[index]->count == BTREE_KEYS) {
+            BTree_SplitChild(tree, inner, index);
+
+            if (biased >= node->keys[index]) {
+                index++;
+            }
+        }
+
+        node = inner->children[index];
+    }
+
+    BTreeLeaf *leaf = (BTreeLeaf *) node;
+    u32 index = BTree_Rank(node, biased);
+    u8 *value = BTree_Value(tree, leaf, index);
+
+    if (index < node->count && node->keys[index] == biased) {
+        if (inserted != NULL) {
+            *inserted = false;
+        }
+
+        return value;
+    }
+
+    u64 stride = BTREE_ALIGN(tree->value_size);
+
+    memmove(node->keys + index + 1, node->keys + index, sizeof(i64) * (node->count - index));
+    memmove(value + stride, value, stride * (node->count - index));
+    memset(value, 0, tree->value_size);
+
+    node->keys[index] = biased;
+    node->count++;
+    tree->count++;
+
+    if (inserted != NULL) {
+        *inserted = true;
+    }
+
+    return value;
+}
+
+bool
+BTree_Insert(BTree *tree, u64 key, const void *value)
+{
+    bool inserted;
+    void *slot = BTree_Upsert(tree, key, &inserted);
+
+    if (inserted && value != NULL) {
+        memcpy(slot, value, tree->value_size);
+    }
+
+    return inserted;
+}
+
+bool
+BTree_Erase(BTree *tree, u64 key)
+{
+    i64 biased = BTREE_BIAS(key);
+
+    BTreeLeaf *leaf = (BTreeLeaf *) (uintptr_t) BTree_FindLeaf(tree, biased);
+    BTreeNode *node = &leaf->node;
+    u32 index = BTree_Rank(node, biased);
+
+    if (index == node->count || node->keys[index] != biased) {
+        return false;
+    }
+
+    u64 stride = BTREE_ALIGN(tree->value_size);
+    u8 *value = BTree_Value(tree, leaf, index);
+
+    memmove(node->keys + index, node->keys + index + 1, sizeof(i64) * (node->count - index - 1));
+    memmove(value, value + stride, stride * (node->count - index - 1));
+
+    node->count--;
+    tree->count--;
+
+    return true;
+}
+
+BTreeIterator
+BTree_Range(const BTree *tree, u64 first, u64 last)
+{
+    const BTreeLeaf *leaf = BTree_FindLeaf(tree, BTREE_BIAS(first));
+
+    return (BTreeIterator) {
+        .leaf = first <= last ? leaf : NULL,
+        .index = BTree_Rank(&leaf->node, BTREE_BIAS(first)),
+        .last = last,
+        .value_size = tree->value_size,
+    };
+}
+
+BTreeIterator
+BTree_Iterate(const BTree *tree)
+{
+    return (BTreeIterator) {
+        .leaf = tree->first,
+        .index = 0,
+        .last = UINT64_MAX,
+        .value_size = tree->value_size,
+    };
+}
+
+bool
+BTreeIterator_Next(BTreeIterator *iterator, u64 *key, void **value)
+{
+    while (iterator->leaf != NULL && iterator->index == iterator->leaf->node.count) {
+        iterator->leaf = iterator->leaf->next;
+        iterator->index = 0;
+    }
+
+    if (iterator->leaf == NULL) {
+        return false;
+    }
+
+    u64 current = BTREE_UNBIAS(iterator->leaf->node.keys[iterator->index]);
+
+    if (current > iterator->last) {
+        iterator->leaf = NULL;
+
+        return false;
+    }
+
+    *key = current;
+    *value = (u8 *) (uintptr_t) iterator->leaf->values + iterator->index * BTREE_ALIGN(iterator->value_size);
+
+    iterator->index++;
+
+    return true;
+}
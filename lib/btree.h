@@ -0,0 +1,42 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef BTREE_H
+#define BTREE_H 1
+
+// Keys per node, every node keeps them in one contiguous sorted array.
+#define BTREE_KEYS 32
+
+typedef struct BTree BTree;
+typedef struct BTreeLeaf BTreeLeaf;
+
+// Values of value_size bytes are stored inline in the leaves.
+typedef struct BTreeConfig {
+    u64 value_size;
+} BTreeConfig;
+
+typedef struct BTreeIterator {
+    const BTreeLeaf *leaf;
+    u64 index;
+    u64 last;
+    u64 value_size;
+} BTreeIterator;
+
+void BTree_Create(BTree **tree, BTreeConfig config);
+void BTree_Destroy(BTree **tree);
+u64 BTree_Count(const BTree *tree);
+
+// Value pointers stay valid until the next BTree_Upsert, BTree_Insert or
+// BTree_Erase.
+void *BTree_Find(const BTree *tree, u64 key);
+void *BTree_Upsert(BTree *tree, u64 key, bool *inserted);
+bool BTree_Insert(BTree *tree, u64 key, const void *value);
+bool BTree_Erase(BTree *tree, u64 key);
+
+// Visits the keys in [first, last] in ascending order. The tree must not
+// change while an iterator is in use.
+BTreeIterator BTree_Range(const BTree *tree, u64 first, u64 last);
+BTreeIterator BTree_Iterate(const BTree *tree);
+bool BTreeIterator_Next(BTreeIterator *iterator, u64 *key, void **value);
+
+#endif // BTREE_H
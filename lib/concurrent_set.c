@@ -0,0 +1,396 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#include <sched.h>
+#include <stdatomic.h>
+
+// Linear probing table whose slots go from empty to a key with a single CAS
+// and never change afterwards, until a resize marks them as moved. Keys equal
+// to the two reserved slot values are tracked with flags on the set.
+//
+// A resize publishes a table twice as large in next. Threads that touch the
+// old table help copy it chunk by chunk, but nobody waits for the copy: an
+// insert first seals the key's probe sequence in the old table, closing its
+// first empty slot, and then goes on to the larger table. A key missing from
+// the sealed sequence can no longer be added to the old table, so it can't
+// be reported as new by two threads. Lookups that reach the end of a probe
+// sequence in a table being moved continue in the next one.
+//
+// The larger table only starts a resize of its own once the copy into it is
+// done. Until then it takes inserts past its load limit, and an insert only
+// has to wait for a stalled copy if the larger table fills up as well.
+#define CONCURRENT_SET_EMPTY ((u64) 0)
+#define CONCURRENT_SET_MOVED UINT64_MAX
+#define CONCURRENT_SET_CHUNK 1024
+#define CONCURRENT_SET_MIN_CAPACITY 64
+
+typedef struct ConcurrentSetTable {
+    _Atomic u64 *slots;
+
+    u64 capacity;
+    u64 limit;
+
+    _Atomic u64 count;
+    _Atomic u64 cursor;
+    _Atomic u64 moved;
+
+    _Atomic(struct ConcurrentSetTable *) next;
+
+    // Older tables may still be read by slow threads, they are freed by
+    // ConcurrentSet_Destroy.
+    struct ConcurrentSetTable *previous;
+} ConcurrentSetTable;
+
+struct ConcurrentSet {
+    _Atomic(ConcurrentSetTable *) table;
+    _Atomic u64 count;
+
+    atomic_bool has_empty;
+    atomic_bool has_moved;
+};
+
+static ConcurrentSetTable *
+ConcurrentSetTable_Create(u64 capacity, ConcurrentSetTable *previous)
+{
+    ConcurrentSetTable *table = malloc(sizeof(ConcurrentSetTable));
+
+    if (table == NULL) {
+        goto out_of_memory;
+    }
+
+    table->slots = malloc(sizeof(_Atomic u64) * capacity);
+
+    if (table->slots == NULL) {
+        goto out_of_memory;
+    }
+
+    for (u64 i = 0; i < capacity; ++i) {
+        atomic_init(&table->slots[i], CONCURRENT_SET_EMPTY);
+    }
+
+    table->capacity = capacity;
+    table->limit = capacity / 2;
+    table->previous = previous;
+
+    atomic_init(&table->count, 0);
+    atomic_init(&table->cursor, 0);
+    atomic_init(&table->moved, 0);
+    atomic_init(&table->next, NULL);
+
+    return table;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+
+    return NULL;
+}
+
+// Adds a key that is known to be absent to a table nobody else is inserting
+// new keys into.
+static void
+ConcurrentSetTable_Place(ConcurrentSetTable *table, u64 key)
+{
+    u64 mask = table->capacity - 1;
+
+    for (u64 index = MapHash_Mix(key) & mask; ; index = (index + 1) & mask) {
+        u64 expected = CONCURRENT_SET_EMPTY;
+
+        if (atomic_compare_exchange_strong(&table->slots[index], &expected, key)) {
+            atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed);
+
+            return;
+        }
+    }
+}
+
+// Copies the unclaimed chunks of a table into its next one. The thread that
+// finishes the last chunk makes the next table the current one.
+static void
+ConcurrentSet_Migrate(ConcurrentSet *set, ConcurrentSetTable *table)
+{
+    ConcurrentSetTable *next = atomic_load(&table->next);
+
+    for (;;) {
+        u64 start = atomic_fetch_add(&table->cursor, CONCURRENT_SET_CHUNK);
+
+        if (start >= table->capacity) {
+            break;
+        }
+
+        u64 end = start + CONCURRENT_SET_CHUNK;
+
+        if (end > table->capacity) {
+            end = table->capacity;
+        }
+
+        for (u64 i = start; i < end; ++i) {
+            u64 key = atomic_load(&table->slots[i]);
+
+            // Closing an empty slot can race with an inserter, in which case
+            // the slot now holds a key that has to be copied, or with a
+            // sealing thread that already closed it.
+            if (key == CONCURRENT_SET_EMPTY) {
+                if (atomic_compare_exchange_strong(&table->slots[i], &key, CONCURRENT_SET_MOVED)) {
+                    continue;
+                }
+            }
+
+            if (key == CONCURRENT_SET_MOVED) {
+                continue;
+            }
+
+            ConcurrentSetTable_Place(next, key);
+            atomic_store(&table->slots[i], CONCURRENT_SET_MOVED);
+        }
+
+        if (atomic_fetch_add(&table->moved, end - start) + (end - start) == table->capacity) {
+            ConcurrentSetTable *expected = table;
+
+            atomic_compare_exchange_strong(&set->table, &expected, next);
+        }
+    }
+}
+
+static void
+ConcurrentSet_Grow(ConcurrentSet *set, ConcurrentSetTable *table)
+{
+    if (atomic_load(&table->next) == NULL) {
+        ConcurrentSetTable *next = ConcurrentSetTable_Create(table->capacity * 2, table);
+        ConcurrentSetTable *expected = NULL;
+
+        if (!atomic_compare_exchange_strong(&table->next, &expected, next)) {
+            free(next->slots);
+            free(next);
+        }
+    }
+
+    ConcurrentSet_Migrate(set, table);
+}
+
+// Closes the first empty slot of the key's probe sequence in a table that is
+// being moved, so the key can't be added to it anymore. Returns true if the
+// key was found first.
+static bool
+ConcurrentSetTable_Seal(ConcurrentSetTable *table, u64 key)
+{
+    u64 mask = table->capacity - 1;
+    u64 index = MapHash_Mix(key) & mask;
+
+    for (u64 probe = 0; probe < table->capacity; ++probe) {
+        u64 current = atomic_load(&table->slots[index]);
+
+        if (current == CONCURRENT_SET_EMPTY) {
+            if (atomic_compare_exchange_strong(&table->slots[index], &current, CONCURRENT_SET_MOVED)) {
+                return false;
+            }
+        }
+
+        if (current == key) {
+            return true;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return false;
+}
+
+typedef enum ConcurrentSetResult {
+    CONCURRENT_SET_ADDED,
+    CONCURRENT_SET_FOUND,
+    CONCURRENT_SET_FULL,
+} ConcurrentSetResult;
+
+// Adds a key to a table while it holds less than limit keys. Reports FULL
+// when the limit is reached or the table is being moved.
+static ConcurrentSetResult
+ConcurrentSetTable_Add(ConcurrentSetTable *table, u64 key, u64 limit)
+{
+    u64 mask = table->capacity - 1;
+    u64 index = MapHash_Mix(key) & mask;
+
+    for (u64 probe = 0; probe < table->capacity; ++probe) {
+        u64 current = atomic_load(&table->slots[index]);
+
+        if (current == CONCURRENT_SET_EMPTY) {
+            if (atomic_load_explicit(&table->count, memory_order_relaxed) >= limit) {
+                return CONCURRENT_SET_FULL;
+            }
+
+            if (atomic_compare_exchange_strong(&table->slots[index], &current, key)) {
+                atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed);
+
+                return CONCURRENT_SET_ADDED;
+            }
+        }
+
+        if (current == key) {
+            return CONCURRENT_SET_FOUND;
+        }
+
+        if (current == CONCURRENT_SET_MOVED) {
+            return CONCURRENT_SET_FULL;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return CONCURRENT_SET_FULL;
+}
+
+void
+ConcurrentSet_Create(ConcurrentSet **set, u64 capacity)
+{
+    *set = malloc(sizeof(ConcurrentSet));
+
+    if (*set == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    u64 size = CONCURRENT_SET_MIN_CAPACITY;
+
+    while (size / 2 < capacity) {
+        size *= 2;
+    }
+
+    atomic_init(&(*set)->table, ConcurrentSetTable_Create(size, NULL));
+    atomic_init(&(*set)->count, 0);
+    atomic_init(&(*set)->has_empty, false);
+    atomic_init(&(*set)->has_moved, false);
+}
+
+void
+ConcurrentSet_Destroy(ConcurrentSet **set)
+{
+    if (set == NULL || *set == NULL) {
+        return;
+    }
+
+    ConcurrentSetTable *table = atomic_load(&(*set)->table);
+
+    while (atomic_load(&table->next) != NULL) {
+        table = atomic_load(&table->next);
+    }
+
+    while (table != NULL) {
+        ConcurrentSetTable *previous = table->previous;
+
+        free(table->slots);
+        free(table);
+
+        table = previous;
+    }
+
+    free(*set);
+
+    *set = NULL;
+}
+
+bool
+ConcurrentSet_InsertIfAbsent(ConcurrentSet *set, u64 key)
+{
+    if (key == CONCURRENT_SET_EMPTY) {
+        return !atomic_exchange(&set->has_empty, true);
+    }
+
+    if (key == CONCURRENT_SET_MOVED) {
+        return !atomic_exchange(&set->has_moved, true);
+    }
+
+    ConcurrentSetTable *table = atomic_load(&set->table);
+
+    for (;;) {
+        ConcurrentSetTable *next = atomic_load(&table->next);
+
+        if (next != NULL) {
+            ConcurrentSet_Migrate(set, table);
+
+            if (ConcurrentSetTable_Seal(table, key)) {
+                return false;
+            }
+
+            table = next;
+
+            continue;
+        }
+
+        // While the copy into this table is running it can't resize, so it
+        // takes keys past its load limit.
+        bool settled = atomic_load(&set->table) == table;
+        u64 limit = settled ? table->limit : table->capacity - table->capacity / 4;
+
+        ConcurrentSetResult result = ConcurrentSetTable_Add(table, key, limit);
+
+        if (result == CONCURRENT_SET_ADDED) {
+            atomic_fetch_add_explicit(&set->count, 1, memory_order_relaxed);
+
+            return true;
+        }
+
+        if (result == CONCURRENT_SET_FOUND) {
+            return false;
+        }
+
+        if (atomic_load(&table->next) != NULL) {
+            continue;
+        }
+
+        ConcurrentSetTable *current = atomic_load(&set->table);
+
+        if (current == table) {
+            ConcurrentSet_Grow(set, table);
+        } else {
+            ConcurrentSet_Migrate(set, current);
+            sched_yield();
+        }
+    }
+}
+
+bool
+ConcurrentSet_Contains(ConcurrentSet *set, u64 key)
+{
+    if (key == CONCURRENT_SET_EMPTY) {
+        return atomic_load(&set->has_empty);
+    }
+
+    if (key == CONCURRENT_SET_MOVED) {
+        return atomic_load(&set->has_moved);
+    }
+
+    ConcurrentSetTable *table = atomic_load(&set->table);
+
+    for (;;) {
+        u64 mask = table->capacity - 1;
+        u64 index = MapHash_Mix(key) & mask;
+
+        for (u64 probe = 0; probe < table->capacity; ++probe) {
+            u64 current = atomic_load(&table->slots[index]);
+
+            if (current == key) {
+                return true;
+            }
+
+            if (current == CONCURRENT_SET_EMPTY) {
+                break;
+            }
+
+            index = (index + 1) & mask;
+        }
+
+        // Moved slots and sealed probe sequences leave the key, if it was
+        // added, in the next table.
+        table = atomic_load(&table->next);
+
+        if (table == NULL) {
+            return false;
+        }
+    }
+}
+
+u64
+ConcurrentSet_Count(ConcurrentSet *set)
+{
+    return atomic_load(&set->count) +
+           (u64) atomic_load(&set->has_empty) +
+           (u64) atomic_load(&set->has_moved);
+}
@@ -0,0 +1,19 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef CONCURRENT_SET_H
+#define CONCURRENT_SET_H 1
+
+// Set of u64 keys that any number of threads may insert into and query at
+// the same time. Create and Destroy must not race with other calls.
+typedef struct ConcurrentSet ConcurrentSet;
+
+void ConcurrentSet_Create(ConcurrentSet **set, u64 capacity);
+void ConcurrentSet_Destroy(ConcurrentSet **set);
+
+// Returns true when key was not in the set and this call added it.
+bool ConcurrentSet_InsertIfAbsent(ConcurrentSet *set, u64 key);
+bool ConcurrentSet_Contains(ConcurrentSet *set, u64 key);
+u64 ConcurrentSet_Count(ConcurrentSet *set);
+
+#endif // CONCURRENT_SET_H
@@ -4,6 +4,10 @@
 #ifndef DEFS_H
 #define DEFS_H 1
 
+#ifndef _DEFAULT_SOURCE
+#    define _DEFAULT_SOURCE 1
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -14,6 +18,7 @@
 #include <ctype.h>
 #include <math.h>
 #include <limits.h>
+#include <stddef.h>
 
 typedef int8_t i8;
 typedef int16_t i16;
@@ -28,10 +33,24 @@ typedef double f64;
 
 #define UNUSED(param) ((void)(param))
 
+#include "slice.h"
 #include "support.h"
 #include "md5.h"
 #include "map.h"
-#include "slice.h"
+#include "map_template.h"
+#include "binary_tree.h"
+#include "bitset.h"
+#include "btree.h"
+#include "heap_template.h"
+#include "vec_template.h"
+#include "matcher.h"
+#include "parse_int.h"
+#include "scanner.h"
+#include "async_reader.h"
+#include "concurrent_set.h"
+#include "arena.h"
+#include "pool.h"
+#include "sparse_grid.h"
 
 #endif // DEFS_H
 
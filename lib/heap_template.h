@@ -0,0 +1,223 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef HEAP_TEMPLATE_H
+#define HEAP_TEMPLATE_H 1
+
+#define HEAP_ABSENT UINT32_MAX
+
+// Defines Name, an indexed binary min-heap of Element ordered by
+// LESS(left, right), which receives elements by value. Every element is
+// pushed under a handle in [0, capacity) that can later be used to change
+// its priority, so a search can push each vertex once and lower its cost in
+// place instead of pushing duplicates.
+//
+//     DEFINE_HEAP(RouteQueue, Route, ROUTE_LESS)
+//
+// defines RouteQueue_Create, _Destroy, _Count, _Contains, _Get, _Push,
+// _Update, _Peek and _Pop. _Update moves a queued handle either way, and
+// _Push behaves like _Update when its handle is already queued.
+#define DEFINE_HEAP(Name, Element, LESS)                                        \
+typedef struct Name {                                                           \
+    Element *items;                                                             \
+    u32 *handles;                                                               \
+    u32 *positions;                                                             \
+                                                                                \
+    u32 count;                                                                  \
+    u32 capacity;                                                               \
+} Name;                                                                         \
+                                                                                \
+static inline void                                                              \
+Name##_Place(Name *heap, u32 position, Element element, u32 handle)             \
+{                                                                               \
+    heap->items[position] = element;                                            \
+    heap->handles[position] = handle;                                           \
+    heap->positions[handle] = position;                                         \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_SiftUp(Name *heap, u32 position)                                         \
+{                                                                               \
+    Element element = heap->items[position];                                    \
+    u32 handle = heap->handles[position];                                       \
+                                                                                \
+    while (position > 0) {                                                      \
+        u32 parent = (position - 1) / 2;                                        \
+                                                                                \
+        if (!(LESS(element, heap->items[parent]))) {                            \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        Name##_Place(heap, position, heap->items[parent], heap->handles[parent]); \
+        position = parent;                                                      \
+    }                                                                           \
+                                                                                \
+    Name##_Place(heap, position, element, handle);                              \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_SiftDown(Name *heap, u32 position)                                       \
+{                                                                               \
+    Element element = heap->items[position];                                    \
+    u32 handle = heap->handles[position];                                       \
+                                                                                \
+    for (;;) {                                                                  \
+        u32 child = position * 2 + 1;                                           \
+                                                                                \
+        if (child >= heap->count) {                                             \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        if (child + 1 < heap->count && LESS(heap->items[child + 1], heap->items[child])) { \
+            child++;                                                            \
+        }                                                                       \
+                                                                                \
+        if (!(LESS(heap->items[child], element))) {                             \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        Name##_Place(heap, position, heap->items[child], heap->handles[child]); \
+        position = child;                                                       \
+    }                                                                           \
+                                                                                \
+    Name##_Place(heap, position, element, handle);                              \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Create(Name **heap, u32 capacity)                                        \
+{                                                                               \
+    *heap = malloc(sizeof(Name));                                               \
+                                                                                \
+    if (*heap == NULL) {                                                        \
+        goto out_of_memory;                                                     \
+    }                                                                           \
+                                                                                \
+    u32 slots = capacity > 0 ? capacity : 1;                                    \
+                                                                                \
+    (*heap)->items = malloc(sizeof(Element) * slots);                           \
+    (*heap)->handles = malloc(sizeof(u32) * slots);                             \
+    (*heap)->positions = malloc(sizeof(u32) * slots);                           \
+                                                                                \
+    if ((*heap)->items == NULL || (*heap)->handles == NULL || (*heap)->positions == NULL) { \
+        goto out_of_memory;                                                     \
+    }                                                                           \
+                                                                                \
+    for (u32 i = 0; i < capacity; ++i) {                                        \
+        (*heap)->positions[i] = HEAP_ABSENT;                                    \
+    }                                                                           \
+                                                                                \
+    (*heap)->count = 0;                                                         \
+    (*heap)->capacity = capacity;                                               \
+                                                                                \
+    return;                                                                     \
+                                                                                \
+out_of_memory:                                                                  \
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__); \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Destroy(Name **heap)                                                     \
+{                                                                               \
+    if (heap == NULL || *heap == NULL) {                                        \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    free((*heap)->items);                                                       \
+    free((*heap)->handles);                                                     \
+    free((*heap)->positions);                                                   \
+    free(*heap);                                                                \
+                                                                                \
+    *heap = NULL;                                                               \
+}                                                                               \
+                                                                                \
+static inline u32                                                               \
+Name##_Count(const Name *heap)                                                  \
+{                                                                               \
+    return heap->count;                                                         \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##_Contains(const Name *heap, u32 handle)                                   \
+{                                                                               \
+    return heap->positions[handle] != HEAP_ABSENT;                              \
+}                                                                               \
+                                                                                \
+static inline const Element *                                                   \
+Name##_Get(const Name *heap, u32 handle)                                        \
+{                                                                               \
+    u32 position = heap->positions[handle];                                     \
+                                                                                \
+    return position == HEAP_ABSENT ? NULL : &heap->items[position];             \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Update(Name *heap, u32 handle, Element element)                          \
+{                                                                               \
+    u32 position = heap->positions[handle];                                     \
+    bool raise = LESS(element, heap->items[position]);                          \
+                                                                                \
+    heap->items[position] = element;                                            \
+                                                                                \
+    if (raise) {                                                                \
+        Name##_SiftUp(heap, position);                                          \
+    } else {                                                                    \
+        Name##_SiftDown(heap, position);                                        \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Push(Name *heap, u32 handle, Element element)                            \
+{                                                                               \
+    if (heap->positions[handle] != HEAP_ABSENT) {                               \
+        Name##_Update(heap, handle, element);                                   \
+                                                                                \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    Name##_Place(heap, heap->count, element, handle);                           \
+    heap->count++;                                                              \
+                                                                                \
+    Name##_SiftUp(heap, heap->count - 1);                                       \
+}                                                                               \
+                                                                                \
+static inline const Element *                                                   \
+Name##_Peek(const Name *heap, u32 *handle)                                      \
+{                                                                               \
+    if (heap->count == 0) {                                                     \
+        return NULL;                                                            \
+    }                                                                           \
+                                                                                \
+    if (handle != NULL) {                                                       \
+        *handle = heap->handles[0];                                             \
+    }                                                                           \
+                                                                                \
+    return &heap->items[0];                                                     \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##_Pop(Name *heap, u32 *handle, Element *element)                           \
+{                                                                               \
+    if (heap->count == 0) {                                                     \
+        return false;                                                           \
+    }                                                                           \
+                                                                                \
+    if (handle != NULL) {                                                       \
+        *handle = heap->handles[0];                                             \
+    }                                                                           \
+                                                                                \
+    if (element != NULL) {                                                      \
+        *element = heap->items[0];                                              \
+    }                                                                           \
+                                                                                \
+    heap->positions[heap->handles[0]] = HEAP_ABSENT;                            \
+    heap->count--;                                                              \
+                                                                                \
+    if (heap->count > 0) {                                                      \
+        Name##_Place(heap, 0, heap->items[heap->count], heap->handles[heap->count]); \
+        Name##_SiftDown(heap, 0);                                               \
+    }                                                                           \
+                                                                                \
+    return true;                                                                \
+}
+
+#endif // HEAP_TEMPLATE_H
@@ -1,24 +1,208 @@
 // Copyright (c) 2022 Gustavo Ribeiro Croscato
 // SPDX-License-Identifier: MIT
 
-typedef struct MapItem {
-    void *key;
-    void *value;
+// Open addressing table with the control byte layout of map_template.h.
+// Entries are stored inline as the key followed by the value.
+#define MAP_ALIGN(size) (((size) + 7) & ~(u64) 7)
 
-    struct MapItem *next;
-} MapItem;
+typedef struct MapCounters {
+    u64 lookups;
+    u64 compares;
+} MapCounters;
 
 struct Map {
-    MapItem **data;
+    u8 *control;
+    u8 *entries;
 
-    u64 size;
+    u64 capacity;
+    u64 count;
+    u64 used;
+    u64 limit;
+
+    u64 key_size;
+    u64 value_size;
+    u64 value_offset;
+    u64 entry_size;
 
     MapKeyHash hash;
     MapKeyCompare compare;
+
+    MapCounters *counters;
 };
 
+static u64
+Map_Hash(const Map *map, const void *key)
+{
+    if (map->hash != NULL) {
+        return MapHash_Mix(map->hash(key));
+    }
+
+    const u8 *bytes = key;
+    u64 size = map->key_size;
+    u64 hash = size;
+
+    while (size >= sizeof(u64)) {
+        u64 word;
+
+        memcpy(&word, bytes, sizeof(u64));
+
+        hash = MapHash_Mix(hash ^ word);
+        bytes += sizeof(u64);
+        size -= sizeof(u64);
+    }
+
+    if (size > 0) {
+        u64 word = 0;
+
+        memcpy(&word, bytes, size);
+
+        hash = MapHash_Mix(hash ^ word);
+    }
+
+    return MapHash_Mix(hash);
+}
+
+static bool
+Map_Compare(const Map *map, const void *left, const void *right)
+{
+    if (map->counters != NULL) {
+        map->counters->compares++;
+    }
+
+    if (map->compare != NULL) {
+        return map->compare(left, right);
+    }
+
+    return memcmp(left, right, map->key_size) == 0;
+}
+
+static inline u8 *
+Map_Entry(const Map *map, u64 slot)
+{
+    return map->entries + slot * map->entry_size;
+}
+
+static void
+Map_Allocate(Map *map, u64 capacity)
+{
+    map->control = malloc(capacity);
+    map->entries = malloc(map->entry_size * capacity);
+
+    if (map->control == NULL || map->entries == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    memset(map->control, MAP_EMPTY, capacity);
+
+    map->capacity = capacity;
+    map->count = 0;
+    map->used = 0;
+    map->limit = capacity / MAP_MAX_LOAD_DENOMINATOR * MAP_MAX_LOAD_NUMERATOR;
+}
+
+// Walks the probe sequence of hash and returns the slot holding key or, when
+// the key is absent, the first free slot where it would be placed.
+static u64
+Map_Probe(const Map *map, u64 hash, const void *key, bool *found)
+{
+    u8 tag = (u8) (hash & 0x7F);
+    u64 mask = map->capacity / MAP_GROUP_WIDTH - 1;
+    u64 group = (hash >> 7) & mask;
+    u64 target = UINT64_MAX;
+
+    if (key != NULL && map->counters != NULL) {
+        map->counters->lookups++;
+    }
+
+    // Triangular steps visit every group of a power-of-two table.
+    for (u64 step = 1; ; ++step) {
+        const u8 *control = map->control + group * MAP_GROUP_WIDTH;
+        u64 base = group * MAP_GROUP_WIDTH;
+
+        if (key != NULL) {
+            u32 matches = MapGroup_Match(control, tag);
+
+            while (matches != 0) {
+                u64 slot = base + (u64) __builtin_ctz(matches);
+
+                if (Map_Compare(map, Map_Entry(map, slot), key)) {
+                    *found = true;
+
+                    return slot;
+                }
+
+                matches &= matches - 1;
+            }
+        }
+
+        if (target == UINT64_MAX) {
+            u32 deleted = MapGroup_Match(control, MAP_DELETED);
+
+            if (deleted != 0) {
+                target = base + (u64) __builtin_ctz(deleted);
+            }
+        }
+
+        u32 empty = MapGroup_Match(control, MAP_EMPTY);
+
+        if (empty != 0) {
+            *found = false;
+
+            return target != UINT64_MAX ? target : base + (u64) __builtin_ctz(empty);
+        }
+
+        group = (group + step) & mask;
+    }
+}
+
+static u8 *
+Map_Place(Map *map, u64 slot, u64 hash, const void *key)
+{
+    if (map->control[slot] == MAP_EMPTY) {
+        map->used++;
+    }
+
+    map->control[slot] = (u8) (hash & 0x7F);
+    map->count++;
+
+    u8 *entry = Map_Entry(map, slot);
+
+    memcpy(entry, key, map->key_size);
+
+    return entry;
+}
+
+// Rehashes into a table twice as large, or the same size when most of the
+// used slots are tombstones left by Map_Remove.
+static void
+Map_Grow(Map *map)
+{
+    u8 *control = map->control;
+    u8 *entries = map->entries;
+    u64 capacity = map->capacity;
+
+    Map_Allocate(map, map->count * 2 >= map->limit ? capacity * 2 : capacity);
+
+    for (u64 i = 0; i < capacity; ++i) {
+        if (control[i] == MAP_EMPTY || control[i] == MAP_DELETED) {
+            continue;
+        }
+
+        const u8 *entry = entries + i * map->entry_size;
+        u64 hash = Map_Hash(map, entry);
+
+        bool found;
+        u64 slot = Map_Probe(map, hash, NULL, &found);
+
+        memcpy(Map_Place(map, slot, hash, entry), entry, map->entry_size);
+    }
+
+    free(control);
+    free(entries);
+}
+
 void
-Map_Create(Map **map, u64 size, MapKeyHash hash, MapKeyCompare compare)
+Map_Create(Map **map, MapConfig config)
 {
     *map = malloc(sizeof(struct Map));
 
@@ -26,20 +210,28 @@ Map_Create(Map **map, u64 size, MapKeyHash hash, MapKeyCompare compare)
         goto out_of_memory;
     }
 
-    (*map)->data = malloc(sizeof(MapItem) * size);
+    (*map)->key_size = config.key_size;
+    (*map)->value_size = config.value_size;
+    (*map)->value_offset = MAP_ALIGN(config.key_size);
+    (*map)->entry_size = MAP_ALIGN(config.key_size) + MAP_ALIGN(config.value_size);
+    (*map)->hash = config.hash;
+    (*map)->compare = config.compare;
+    (*map)->counters = NULL;
 
-    if ((*map)->data == NULL) {
-        goto out_of_memory;
-    }
+    if (config.stats) {
+        (*map)->counters = calloc(1, sizeof(MapCounters));
 
-    (*map)->size = size;
-    (*map)->hash = hash;
-    (*map)->compare = compare;
+        if ((*map)->counters == NULL) {
+            goto out_of_memory;
+        }
+    }
 
-    for (u64 i = 0; i < (*map)->size; ++i) {
-        (*map)->data[i] = NULL;
+    if ((*map)->entry_size == 0) {
+        (*map)->entry_size = sizeof(u64);
     }
 
+    Map_Allocate(*map, MapCapacity_For(config.capacity));
+
     return;
 
 out_of_memory:
@@ -53,70 +245,234 @@ Map_Destroy(Map **map)
         return;
     }
 
-    for (u64 i = 0; i < (*map)->size; ++i) {
-        MapItem *item = (*map)->data[i];
+    if ((*map)->counters != NULL) {
+        Map_PrintStats(*map, stderr);
+    }
 
-        if (item == NULL) {
-            continue;
-        }
+    free((*map)->control);
+    free((*map)->entries);
+    free((*map)->counters);
+    free(*map);
 
-        MapItem *parent;
+    *map = NULL;
+}
 
-        while (item != NULL) {
-            parent = item;
-            item = item->next;
+u64
+Map_Count(const Map *map)
+{
+    return map->count;
+}
 
-            free(parent->key);
-            free(parent->value);
-            free(parent);
-        }
+void *
+Map_Find(const Map *map, const void *key)
+{
+    bool found;
+    u64 slot = Map_Probe(map, Map_Hash(map, key), key, &found);
+
+    if (!found) {
+        return NULL;
     }
 
-    free((*map)->data);
-    free(*map);
+    return Map_Entry(map, slot) + map->value_offset;
+}
 
-    *map = NULL;
+void *
+Map_Upsert(Map *map, const void *key, bool *inserted)
+{
+    u64 hash = Map_Hash(map, key);
+
+    bool found;
+    u64 slot = Map_Probe(map, hash, key, &found);
+
+    if (inserted != NULL) {
+        *inserted = !found;
+    }
+
+    if (found) {
+        return Map_Entry(map, slot) + map->value_offset;
+    }
+
+    if (map->control[slot] == MAP_EMPTY && map->used >= map->limit) {
+        Map_Grow(map);
+
+        slot = Map_Probe(map, hash, NULL, &found);
+    }
+
+    u8 *value = Map_Place(map, slot, hash, key) + map->value_offset;
+
+    memset(value, 0, map->value_size);
+
+    return value;
+}
+
+bool
+Map_Insert(Map *map, const void *key, const void *value)
+{
+    bool inserted;
+    void *slot = Map_Upsert(map, key, &inserted);
+
+    if (inserted && value != NULL) {
+        memcpy(slot, value, map->value_size);
+    }
+
+    return inserted;
 }
 
 bool
-Map_Insert(Map *map, void *key, void *value)
+Map_Remove(Map *map, const void *key)
 {
-    u64 hash = map->hash(key);
+    bool found;
+    u64 slot = Map_Probe(map, Map_Hash(map, key), key, &found);
+
+    if (!found) {
+        return false;
+    }
 
-    MapItem *item = map->data[hash];
-    MapItem *parent = NULL;
+    // A group with an empty byte never continued a probe sequence, so the
+    // slot can go straight back to empty instead of becoming a tombstone.
+    u64 base = slot - slot % MAP_GROUP_WIDTH;
 
-    if (item != NULL) {
-        do {
-            if (map->compare(item->key, key)) {
-                free(key);
-                free(value);
+    if (MapGroup_Match(map->control + base, MAP_EMPTY) != 0) {
+        map->control[slot] = MAP_EMPTY;
+        map->used--;
+    } else {
+        map->control[slot] = MAP_DELETED;
+    }
+
+    map->count--;
 
-                return false;
+    return true;
+}
+
+MapStats
+Map_Stats(const Map *map)
+{
+    MapStats stats = {0};
+
+    stats.entries = map->count;
+    stats.capacity = map->capacity;
+    stats.tombstones = map->used - map->count;
+    stats.groups = map->capacity / MAP_GROUP_WIDTH;
+
+    if (map->counters != NULL) {
+        stats.lookups = map->counters->lookups;
+        stats.compares = map->counters->compares;
+    }
+
+    u64 mask = stats.groups - 1;
+    u64 total = 0;
+
+    for (u64 group = 0; group < stats.groups; ++group) {
+        bool used = false;
+
+        for (u64 slot = group * MAP_GROUP_WIDTH; slot < (group + 1) * MAP_GROUP_WIDTH; ++slot) {
+            if (map->control[slot] == MAP_EMPTY || map->control[slot] == MAP_DELETED) {
+                continue;
+            }
+
+            used = true;
+
+            // Replays the probe sequence of the entry until it reaches its group.
+            u64 current = (Map_Hash(map, Map_Entry(map, slot)) >> 7) & mask;
+            u64 length = 1;
+
+            for (u64 step = 1; current != group; ++step) {
+                current = (current + step) & mask;
+                length++;
+            }
+
+            total += length;
+
+            if (length > stats.max_probe) {
+                stats.max_probe = length;
             }
 
-            parent = item;
-            item = item->next;
-        } while (item != NULL);
+            stats.histogram[length < MAP_STATS_HISTOGRAM ? length - 1 : MAP_STATS_HISTOGRAM - 1]++;
+        }
+
+        if (used) {
+            stats.groups_used++;
+        }
     }
 
-    item = malloc(sizeof(MapItem));
+    if (stats.entries > 0) {
+        stats.mean_probe = (f64) total / (f64) stats.entries;
+    }
 
-    if (item == NULL) {
-        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    return stats;
+}
+
+void
+Map_PrintStats(const Map *map, FILE *stream)
+{
+    MapStats stats = Map_Stats(map);
+
+    fprintf(
+        stream,
+        "Map: %" PRIu64 " entries, %" PRIu64 " slots (load %.3f), %" PRIu64 " tombstones\n",
+        stats.entries,
+        stats.capacity,
+        (f64) stats.entries / (f64) stats.capacity,
+        stats.tombstones
+    );
+
+    fprintf(
+        stream,
+        "Map: %" PRIu64 " of %" PRIu64 " groups used, probe length max %" PRIu64 " mean %.3f\n",
+        stats.groups_used,
+        stats.groups,
+        stats.max_probe,
+        stats.mean_probe
+    );
+
+    if (stats.lookups > 0) {
+        fprintf(
+            stream,
+            "Map: %" PRIu64 " lookups, %" PRIu64 " compares (%.3f per lookup)\n",
+            stats.lookups,
+            stats.compares,
+            (f64) stats.compares / (f64) stats.lookups
+        );
     }
 
-    item->key = key;
-    item->value = value;
-    item->next = NULL;
+    for (u64 i = 0; i < MAP_STATS_HISTOGRAM; ++i) {
+        if (stats.histogram[i] == 0) {
+            continue;
+        }
 
-    if (parent) {
-        parent->next = item;
-    } else {
-        map->data[hash] = item;
+        fprintf(
+            stream,
+            "Map: probe %2" PRIu64 "%s %" PRIu64 "\n",
+            i + 1,
+            i == MAP_STATS_HISTOGRAM - 1 ? "+" : " ",
+            stats.histogram[i]
+        );
     }
+}
 
-    return true;
+MapIterator
+Map_Iterate(const Map *map)
+{
+    return (MapIterator) {map, 0};
 }
 
+bool
+MapIterator_Next(MapIterator *iterator, MapEntry *entry)
+{
+    const Map *map = iterator->map;
+
+    while (iterator->index < map->capacity) {
+        u64 slot = iterator->index++;
+
+        if (map->control[slot] == MAP_EMPTY || map->control[slot] == MAP_DELETED) {
+            continue;
+        }
+
+        entry->key = Map_Entry(map, slot);
+        entry->value = Map_Entry(map, slot) + map->value_offset;
 
+        return true;
+    }
+
+    return false;
+}
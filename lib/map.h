@@ -6,11 +6,68 @@
 
 typedef struct Map Map;
 
-typedef u64 (*MapKeyHash)(void *key);
-typedef bool (*MapKeyCompare)(void *key1, void *key2);
+typedef u64 (*MapKeyHash)(const void *key);
+typedef bool (*MapKeyCompare)(const void *key1, const void *key2);
 
-void Map_Create(Map **map, u64 size, MapKeyHash hash, MapKeyCompare compare);
+#define MAP_STATS_HISTOGRAM 16
+
+// Keys and values are copied into the map. A NULL hash or compare falls
+// back to hashing and comparing the key_size bytes of the key. capacity is
+// the expected number of entries, the map grows past it as needed. With
+// stats set, lookups and compare calls are counted and Map_Destroy prints
+// Map_PrintStats to stderr.
+typedef struct MapConfig {
+    u64 key_size;
+    u64 value_size;
+    u64 capacity;
+
+    MapKeyHash hash;
+    MapKeyCompare compare;
+
+    bool stats;
+} MapConfig;
+
+// Probe lengths count the groups visited to reach an entry, 1 being its home
+// group. The last histogram bucket also holds every longer probe.
+typedef struct MapStats {
+    u64 entries;
+    u64 capacity;
+    u64 tombstones;
+    u64 groups;
+    u64 groups_used;
+
+    u64 max_probe;
+    f64 mean_probe;
+    u64 histogram[MAP_STATS_HISTOGRAM];
+
+    u64 lookups;
+    u64 compares;
+} MapStats;
+
+typedef struct MapEntry {
+    const void *key;
+    void *value;
+} MapEntry;
+
+typedef struct MapIterator {
+    const Map *map;
+    u64 index;
+} MapIterator;
+
+void Map_Create(Map **map, MapConfig config);
 void Map_Destroy(Map **map);
-bool Map_Insert(Map *map, void *key, void *value);
+u64 Map_Count(const Map *map);
+
+// Value pointers stay valid until the next Map_Insert, Map_Upsert or Map_Remove.
+void *Map_Find(const Map *map, const void *key);
+void *Map_Upsert(Map *map, const void *key, bool *inserted);
+bool Map_Insert(Map *map, const void *key, const void *value);
+bool Map_Remove(Map *map, const void *key);
+
+MapStats Map_Stats(const Map *map);
+void Map_PrintStats(const Map *map, FILE *stream);
+
+MapIterator Map_Iterate(const Map *map);
+bool MapIterator_Next(MapIterator *iterator, MapEntry *entry);
 
 #endif // MAP_H
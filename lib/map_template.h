@@ -0,0 +1,331 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef MAP_TEMPLATE_H
+#define MAP_TEMPLATE_H 1
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+// Control bytes shared by Map and the DEFINE_MAP tables. A slot is
+// MAP_EMPTY, MAP_DELETED or holds the low 7 bits of its key hash.
+#define MAP_GROUP_WIDTH 16
+#define MAP_EMPTY ((u8) 0x80)
+#define MAP_DELETED ((u8) 0xFE)
+#define MAP_MAX_LOAD_NUMERATOR 7
+#define MAP_MAX_LOAD_DENOMINATOR 8
+
+static inline u64
+MapHash_Mix(u64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static inline u32
+MapGroup_Match(const u8 *group, u8 value)
+{
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128((const __m128i *) (const void *) group);
+
+    return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char) value)));
+#else
+    u32 mask = 0;
+
+    for (u32 i = 0; i < MAP_GROUP_WIDTH; ++i) {
+        if (group[i] == value) {
+            mask |= 1U << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+static inline u64
+MapCapacity_For(u64 count)
+{
+    u64 capacity = MAP_GROUP_WIDTH;
+
+    while (capacity / MAP_MAX_LOAD_DENOMINATOR * MAP_MAX_LOAD_NUMERATOR < count) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+// Defines Name, a map from Key to Value with the same layout and probing as
+// Map but with HASH(key) and EQUALS(left, right) expanded inline. Both macros
+// receive keys by value; HASH does not need to be well mixed.
+//
+//     DEFINE_MAP(CoordSet, Coord, u64, Coord_Hash, Coord_Equals)
+//
+// defines CoordSet_Create, _Destroy, _Count, _Find, _Upsert, _Insert,
+// _Remove and CoordSetIterator with CoordSet_Iterate/CoordSetIterator_Next.
+#define DEFINE_MAP(Name, Key, Value, HASH, EQUALS)                              \
+typedef struct Name {                                                           \
+    u8 *control;                                                                \
+    Key *keys;                                                                  \
+    Value *values;                                                              \
+                                                                                \
+    u64 capacity;                                                               \
+    u64 count;                                                                  \
+    u64 used;                                                                   \
+    u64 limit;                                                                  \
+} Name;                                                                         \
+                                                                                \
+typedef struct Name##Iterator {                                                 \
+    const Name *map;                                                            \
+    u64 index;                                                                  \
+} Name##Iterator;                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Allocate(Name *map, u64 capacity)                                        \
+{                                                                               \
+    map->control = malloc(capacity);                                            \
+    map->keys = malloc(sizeof(Key) * capacity);                                 \
+    map->values = malloc(sizeof(Value) * capacity);                             \
+                                                                                \
+    if (map->control == NULL || map->keys == NULL || map->values == NULL) {     \
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__); \
+    }                                                                           \
+                                                                                \
+    memset(map->control, MAP_EMPTY, capacity);                                  \
+                                                                                \
+    map->capacity = capacity;                                                   \
+    map->count = 0;                                                             \
+    map->used = 0;                                                              \
+    map->limit = capacity / MAP_MAX_LOAD_DENOMINATOR * MAP_MAX_LOAD_NUMERATOR;  \
+}                                                                               \
+                                                                                \
+static inline u64                                                               \
+Name##_Probe(const Name *map, u64 hash, const Key *key, bool *found)            \
+{                                                                               \
+    u8 tag = (u8) (hash & 0x7F);                                                \
+    u64 mask = map->capacity / MAP_GROUP_WIDTH - 1;                             \
+    u64 group = (hash >> 7) & mask;                                             \
+    u64 target = UINT64_MAX;                                                    \
+                                                                                \
+    for (u64 step = 1; ; ++step) {                                              \
+        const u8 *control = map->control + group * MAP_GROUP_WIDTH;             \
+        u64 base = group * MAP_GROUP_WIDTH;                                     \
+                                                                                \
+        if (key != NULL) {                                                      \
+            u32 matches = MapGroup_Match(control, tag);                         \
+                                                                                \
+            while (matches != 0) {                                              \
+                u64 slot = base + (u64) __builtin_ctz(matches);                 \
+                                                                                \
+                if (EQUALS(map->keys[slot], *key)) {                            \
+                    *found = true;                                              \
+                                                                                \
+                    return slot;                                                \
+                }                                                               \
+                                                                                \
+                matches &= matches - 1;                                         \
+            }                                                                   \
+        }                                                                       \
+                                                                                \
+        if (target == UINT64_MAX) {                                             \
+            u32 deleted = MapGroup_Match(control, MAP_DELETED);                 \
+                                                                                \
+            if (deleted != 0) {                                                 \
+                target = base + (u64) __builtin_ctz(deleted);                   \
+            }                                                                   \
+        }                                                                       \
+                                                                                \
+        u32 empty = MapGroup_Match(control, MAP_EMPTY);                         \
+                                                                                \
+        if (empty != 0) {                                                       \
+            *found = false;                                                     \
+                                                                                \
+            return target != UINT64_MAX ? target : base + (u64) __builtin_ctz(empty); \
+        }                                                                       \
+                                                                                \
+        group = (group + step) & mask;                                          \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Place(Name *map, u64 slot, u64 hash, Key key)                            \
+{                                                                               \
+    if (map->control[slot] == MAP_EMPTY) {                                      \
+        map->used++;                                                            \
+    }                                                                           \
+                                                                                \
+    map->control[slot] = (u8) (hash & 0x7F);                                    \
+    map->keys[slot] = key;                                                      \
+    map->count++;                                                               \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Grow(Name *map)                                                          \
+{                                                                               \
+    u8 *control = map->control;                                                 \
+    Key *keys = map->keys;                                                      \
+    Value *values = map->values;                                                \
+    u64 capacity = map->capacity;                                               \
+                                                                                \
+    Name##_Allocate(map, map->count * 2 >= map->limit ? capacity * 2 : capacity); \
+                                                                                \
+    for (u64 i = 0; i < capacity; ++i) {                                        \
+        if (control[i] == MAP_EMPTY || control[i] == MAP_DELETED) {             \
+            continue;                                                           \
+        }                                                                       \
+                                                                                \
+        u64 hash = MapHash_Mix(HASH(keys[i]));                                  \
+                                                                                \
+        bool found;                                                             \
+        u64 slot = Name##_Probe(map, hash, NULL, &found);                       \
+                                                                                \
+        Name##_Place(map, slot, hash, keys[i]);                                 \
+        map->values[slot] = values[i];                                          \
+    }                                                                           \
+                                                                                \
+    free(control);                                                              \
+    free(keys);                                                                 \
+    free(values);                                                               \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Create(Name **map, u64 capacity)                                         \
+{                                                                               \
+    *map = malloc(sizeof(Name));                                                \
+                                                                                \
+    if (*map == NULL) {                                                         \
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__); \
+    }                                                                           \
+                                                                                \
+    Name##_Allocate(*map, MapCapacity_For(capacity));                           \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Destroy(Name **map)                                                      \
+{                                                                               \
+    if (map == NULL || *map == NULL) {                                          \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    free((*map)->control);                                                      \
+    free((*map)->keys);                                                         \
+    free((*map)->values);                                                       \
+    free(*map);                                                                 \
+                                                                                \
+    *map = NULL;                                                                \
+}                                                                               \
+                                                                                \
+static inline u64                                                               \
+Name##_Count(const Name *map)                                                   \
+{                                                                               \
+    return map->count;                                                          \
+}                                                                               \
+                                                                                \
+static inline Value *                                                           \
+Name##_Find(const Name *map, Key key)                                           \
+{                                                                               \
+    bool found;                                                                 \
+    u64 slot = Name##_Probe(map, MapHash_Mix(HASH(key)), &key, &found);         \
+                                                                                \
+    return found ? &map->values[slot] : NULL;                                   \
+}                                                                               \
+                                                                                \
+static inline Value *                                                           \
+Name##_Upsert(Name *map, Key key, bool *inserted)                               \
+{                                                                               \
+    u64 hash = MapHash_Mix(HASH(key));                                          \
+                                                                                \
+    bool found;                                                                 \
+    u64 slot = Name##_Probe(map, hash, &key, &found);                           \
+                                                                                \
+    if (inserted != NULL) {                                                     \
+        *inserted = !found;                                                     \
+    }                                                                           \
+                                                                                \
+    if (found) {                                                                \
+        return &map->values[slot];                                              \
+    }                                                                           \
+                                                                                \
+    if (map->control[slot] == MAP_EMPTY && map->used >= map->limit) {           \
+        Name##_Grow(map);                                                       \
+                                                                                \
+        slot = Name##_Probe(map, hash, NULL, &found);                           \
+    }                                                                           \
+                                                                                \
+    Name##_Place(map, slot, hash, key);                                         \
+                                                                                \
+    memset(&map->values[slot], 0, sizeof(Value));                               \
+                                                                                \
+    return &map->values[slot];                                                  \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##_Insert(Name *map, Key key, Value value)                                  \
+{                                                                               \
+    bool inserted;                                                              \
+    Value *slot = Name##_Upsert(map, key, &inserted);                           \
+                                                                                \
+    if (inserted) {                                                             \
+        *slot = value;                                                          \
+    }                                                                           \
+                                                                                \
+    return inserted;                                                            \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##_Remove(Name *map, Key key)                                               \
+{                                                                               \
+    bool found;                                                                 \
+    u64 slot = Name##_Probe(map, MapHash_Mix(HASH(key)), &key, &found);         \
+                                                                                \
+    if (!found) {                                                               \
+        return false;                                                           \
+    }                                                                           \
+                                                                                \
+    u64 base = slot - slot % MAP_GROUP_WIDTH;                                   \
+                                                                                \
+    if (MapGroup_Match(map->control + base, MAP_EMPTY) != 0) {                  \
+        map->control[slot] = MAP_EMPTY;                                         \
+        map->used--;                                                            \
+    } else {                                                                    \
+        map->control[slot] = MAP_DELETED;                                       \
+    }                                                                           \
+                                                                                \
+    map->count--;                                                               \
+                                                                                \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline Name##Iterator                                                    \
+Name##_Iterate(const Name *map)                                                 \
+{                                                                               \
+    return (Name##Iterator) {map, 0};                                           \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##Iterator_Next(Name##Iterator *iterator, const Key **key, Value **value)   \
+{                                                                               \
+    const Name *map = iterator->map;                                            \
+                                                                                \
+    while (iterator->index < map->capacity) {                                   \
+        u64 slot = iterator->index++;                                           \
+                                                                                \
+        if (map->control[slot] == MAP_EMPTY || map->control[slot] == MAP_DELETED) { \
+            continue;                                                           \
+        }                                                                       \
+                                                                                \
+        *key = &map->keys[slot];                                                \
+        *value = &map->values[slot];                                            \
+                                                                                \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    return false;                                                               \
+}
+
+#endif // MAP_TEMPLATE_H
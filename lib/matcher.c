@@ -0,0 +1,235 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Aho-Corasick automaton compiled into a dense transition table, so a scan
+// is one table lookup per input byte regardless of the number of patterns.
+
+#define MATCHER_ALPHABET 256
+#define MATCHER_NONE UINT32_MAX
+
+typedef struct MatcherState {
+    u32 next[MATCHER_ALPHABET];
+    u32 fail;
+    u32 pattern;
+    u32 output;
+} MatcherState;
+
+struct Matcher {
+    MatcherState *states;
+    u32 state_count;
+
+    u64 *sizes;
+    u64 pattern_count;
+
+    u8 fold[MATCHER_ALPHABET];
+};
+
+static u32
+Matcher_NewState(Matcher *matcher, u32 *capacity)
+{
+    if (matcher->state_count == *capacity) {
+        *capacity *= 2;
+
+        MatcherState *grown = realloc(matcher->states, sizeof(MatcherState) * *capacity);
+
+        if (grown == NULL) {
+            Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+        }
+
+        matcher->states = grown;
+    }
+
+    MatcherState *state = &matcher->states[matcher->state_count];
+
+    for (u32 i = 0; i < MATCHER_ALPHABET; ++i) {
+        state->next[i] = MATCHER_NONE;
+    }
+
+    state->fail = 0;
+    state->pattern = MATCHER_NONE;
+    state->output = MATCHER_NONE;
+
+    return matcher->state_count++;
+}
+
+static void
+Matcher_Build(Matcher *matcher)
+{
+    u32 *queue = malloc(sizeof(u32) * matcher->state_count);
+
+    if (queue == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    u32 head = 0;
+    u32 tail = 0;
+
+    MatcherState *root = &matcher->states[0];
+
+    for (u32 i = 0; i < MATCHER_ALPHABET; ++i) {
+        if (root->next[i] == MATCHER_NONE) {
+            root->next[i] = 0;
+        } else {
+            matcher->states[root->next[i]].fail = 0;
+            queue[tail++] = root->next[i];
+        }
+    }
+
+    while (head < tail) {
+        u32 current = queue[head++];
+        MatcherState *state = &matcher->states[current];
+        MatcherState *fail = &matcher->states[state->fail];
+
+        state->output = (fail->pattern != MATCHER_NONE) ? state->fail : fail->output;
+
+        for (u32 i = 0; i < MATCHER_ALPHABET; ++i) {
+            u32 child = state->next[i];
+
+            if (child == MATCHER_NONE) {
+                state->next[i] = fail->next[i];
+            } else {
+                matcher->states[child].fail = fail->next[i];
+                queue[tail++] = child;
+            }
+        }
+    }
+
+    free(queue);
+}
+
+void
+Matcher_Create(Matcher **matcher, const Slice *patterns, u64 count, bool ignore_case)
+{
+    *matcher = malloc(sizeof(struct Matcher));
+
+    if (*matcher == NULL) {
+        goto out_of_memory;
+    }
+
+    u32 capacity = 16;
+
+    (*matcher)->states = malloc(sizeof(MatcherState) * capacity);
+    (*matcher)->sizes = malloc(sizeof(u64) * (count ? count : 1));
+
+    if ((*matcher)->states == NULL || (*matcher)->sizes == NULL) {
+        goto out_of_memory;
+    }
+
+    (*matcher)->state_count = 0;
+    (*matcher)->pattern_count = count;
+
+    for (u32 i = 0; i < MATCHER_ALPHABET; ++i) {
+        (*matcher)->fold[i] = (u8) (ignore_case ? tolower((int) i) : (int) i);
+    }
+
+    Matcher_NewState(*matcher, &capacity);
+
+    for (u64 i = 0; i < count; ++i) {
+        (*matcher)->sizes[i] = patterns[i].size;
+
+        if (patterns[i].size == 0) {
+            continue;
+        }
+
+        u32 current = 0;
+
+        for (u64 j = 0; j < patterns[i].size; ++j) {
+            u8 symbol = (*matcher)->fold[(u8) patterns[i].data[j]];
+
+            if ((*matcher)->states[current].next[symbol] == MATCHER_NONE) {
+                u32 state = Matcher_NewState(*matcher, &capacity);
+
+                (*matcher)->states[current].next[symbol] = state;
+            }
+
+            current = (*matcher)->states[current].next[symbol];
+        }
+
+        if ((*matcher)->states[current].pattern == MATCHER_NONE) {
+            (*matcher)->states[current].pattern = (u32) i;
+        }
+    }
+
+    Matcher_Build(*matcher);
+
+    return;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+void
+Matcher_Destroy(Matcher **matcher)
+{
+    if (matcher == NULL || *matcher == NULL) {
+        return;
+    }
+
+    free((*matcher)->states);
+    free((*matcher)->sizes);
+    free(*matcher);
+
+    *matcher = NULL;
+}
+
+static bool
+Matcher_FirstCallback(MatcherMatch match, void *context)
+{
+    if (context != NULL) {
+        *(MatcherMatch *) context = match;
+    }
+
+    return false;
+}
+
+// Reports the match that ends first in the input.
+bool
+Matcher_First(const Matcher *matcher, const Slice input, MatcherMatch *match)
+{
+    return Matcher_Scan(matcher, input, Matcher_FirstCallback, match) > 0;
+}
+
+// Reports every match in order of its end position. The scan stops early
+// when the callback returns false. Returns the number of reported matches.
+u64
+Matcher_Scan(const Matcher *matcher, const Slice input, MatcherCallback callback, void *context)
+{
+    if (matcher == NULL || input.data == NULL) {
+        return 0;
+    }
+
+    const MatcherState *states = matcher->states;
+    u32 current = 0;
+    u64 found = 0;
+
+    for (u64 i = 0; i < input.size; ++i) {
+        current = states[current].next[matcher->fold[(u8) input.data[i]]];
+
+        u32 output = (states[current].pattern != MATCHER_NONE) ? current : states[current].output;
+
+        while (output != MATCHER_NONE) {
+            u32 pattern = states[output].pattern;
+            u64 size = matcher->sizes[pattern];
+
+            found++;
+
+            if (!callback((MatcherMatch){pattern, i + 1 - size, size}, context)) {
+                return found;
+            }
+
+            output = states[output].output;
+        }
+    }
+
+    return found;
+}
+
+bool
+Matcher_Step(const Matcher *matcher, u32 *state, char symbol)
+{
+    const MatcherState *states = matcher->states;
+
+    *state = states[*state].next[matcher->fold[(u8) symbol]];
+
+    return states[*state].pattern != MATCHER_NONE || states[*state].output != MATCHER_NONE;
+}
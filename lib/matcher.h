@@ -0,0 +1,26 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef MATCHER_H
+#define MATCHER_H 1
+
+typedef struct Matcher Matcher;
+
+typedef struct MatcherMatch {
+    u64 pattern;
+    u64 offset;
+    u64 size;
+} MatcherMatch;
+
+typedef bool (*MatcherCallback)(MatcherMatch match, void *context);
+
+void Matcher_Create(Matcher **matcher, const Slice *patterns, u64 count, bool ignore_case);
+void Matcher_Destroy(Matcher **matcher);
+bool Matcher_First(const Matcher *matcher, const Slice input, MatcherMatch *match);
+u64 Matcher_Scan(const Matcher *matcher, const Slice input, MatcherCallback callback, void *context);
+
+// Feeds one byte to the automaton for callers that walk the input in their
+// own loop. state starts at 0; returns true when a pattern ends at the byte.
+bool Matcher_Step(const Matcher *matcher, u32 *state, char symbol);
+
+#endif // MATCHER_H
@@ -0,0 +1,166 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// The parsers below return the number of bytes consumed and 0 when the
+// slice does not start with a digit or the value does not fit the type.
+// Digits are classified and converted eight at a time inside a u64
+// (SWAR), so there is no locale lookup, no errno and one multiply chain
+// per eight digits.
+
+#define PARSE_INT_LANES 8
+
+static const u64 ParseInt_Pow10[PARSE_INT_LANES + 1] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+};
+
+static u64
+ParseInt_Load(const char *data, u64 available)
+{
+    u64 word = 0;
+
+    memcpy(&word, data, (available < PARSE_INT_LANES) ? available : PARSE_INT_LANES);
+
+    return word;
+}
+
+// Number of leading digit bytes in a little-endian word. A byte is a digit
+// when its high nibble is 3 and its low nibble plus 6 does not carry into
+// the high nibble.
+static u64
+ParseInt_DigitCount(u64 word)
+{
+    u64 high = (word & 0xF0F0F0F0F0F0F0F0ull) ^ 0x3030303030303030ull;
+    u64 low = ((word & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull;
+    u64 invalid = high | low;
+
+    invalid = (((invalid & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | invalid) & 0x8080808080808080ull;
+
+    if (invalid == 0) {
+        return PARSE_INT_LANES;
+    }
+
+    return (u64) __builtin_ctzll(invalid) / 8;
+}
+
+static u64
+ParseInt_Convert(u64 word, u64 digits)
+{
+    word = (word & 0x0F0F0F0F0F0F0F0Full) << (8 * (PARSE_INT_LANES - digits));
+
+    word = (word * 2561) >> 8;
+    word = ((word & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    word = ((word & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+
+    return word;
+}
+
+static u64
+ParseInt_Unsigned(const Slice slice, u64 *value, u64 limit)
+{
+    if (slice.data == NULL || slice.size == 0) {
+        return 0;
+    }
+
+    u64 result = 0;
+    u64 position = 0;
+
+    while (position < slice.size) {
+        u64 word = ParseInt_Load(slice.data + position, slice.size - position);
+        u64 digits = ParseInt_DigitCount(word);
+
+        if (digits > slice.size - position) {
+            digits = slice.size - position;
+        }
+
+        if (digits == 0) {
+            break;
+        }
+
+        if (
+            __builtin_mul_overflow(result, ParseInt_Pow10[digits], &result) ||
+            __builtin_add_overflow(result, ParseInt_Convert(word, digits), &result)
+        ) {
+            return 0;
+        }
+
+        position += digits;
+
+        if (digits < PARSE_INT_LANES) {
+            break;
+        }
+    }
+
+    if (position == 0 || result > limit) {
+        return 0;
+    }
+
+    *value = result;
+
+    return position;
+}
+
+u64
+ParseInt_U16(const Slice slice, u16 *value)
+{
+    u64 result;
+    u64 size = ParseInt_Unsigned(slice, &result, UINT16_MAX);
+
+    if (size != 0) {
+        *value = (u16) result;
+    }
+
+    return size;
+}
+
+u64
+ParseInt_U32(const Slice slice, u32 *value)
+{
+    u64 result;
+    u64 size = ParseInt_Unsigned(slice, &result, UINT32_MAX);
+
+    if (size != 0) {
+        *value = (u32) result;
+    }
+
+    return size;
+}
+
+u64
+ParseInt_U64(const Slice slice, u64 *value)
+{
+    return ParseInt_Unsigned(slice, value, UINT64_MAX);
+}
+
+u64
+ParseInt_I64(const Slice slice, i64 *value)
+{
+    if (slice.data == NULL || slice.size == 0) {
+        return 0;
+    }
+
+    bool negative = slice.data[0] == '-';
+    u64 sign = (negative || slice.data[0] == '+') ? 1 : 0;
+    u64 magnitude;
+
+    u64 size = ParseInt_Unsigned(
+        (Slice){slice.data + sign, slice.size - sign},
+        &magnitude,
+        negative ? (u64) INT64_MAX + 1 : (u64) INT64_MAX
+    );
+
+    if (size == 0) {
+        return 0;
+    }
+
+    *value = negative ? (i64) (0 - magnitude) : (i64) magnitude;
+
+    return size + sign;
+}
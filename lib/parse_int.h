@@ -0,0 +1,12 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef PARSE_INT_H
+#define PARSE_INT_H 1
+
+u64 ParseInt_U16(const Slice slice, u16 *value);
+u64 ParseInt_U32(const Slice slice, u32 *value);
+u64 ParseInt_U64(const Slice slice, u64 *value);
+u64 ParseInt_I64(const Slice slice, i64 *value);
+
+#endif // PARSE_INT_H
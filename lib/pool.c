@@ -0,0 +1,408 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+
+#define POOL_DEFAULT_SLAB_OBJECTS 256
+#define POOL_CACHE_BATCH 32
+#define POOL_THREAD_CACHES 8
+#define POOL_ALIGN(size) (((size) + 15) & ~(u64) 15)
+
+#if defined(LIB_C_DEBUG)
+// Freed objects are stamped after their free list link, an object that still
+// carries the stamp when it is freed again was never handed out in between.
+#    define POOL_FREED_STAMP ((uintptr_t) 0x5A5AF4EEDF4EE5A5ULL)
+#endif
+
+typedef struct PoolObject {
+    struct PoolObject *next;
+#if defined(LIB_C_DEBUG)
+    uintptr_t stamp;
+#endif
+} PoolObject;
+
+typedef struct PoolSlab {
+    struct PoolSlab *next;
+    max_align_t objects[];
+} PoolSlab;
+
+struct Pool {
+    PoolObject *free;
+    PoolSlab *slabs;
+
+    u64 object_size;
+    u64 slab_objects;
+
+    u64 slab_count;
+
+    bool thread_cache;
+    atomic_flag lock;
+    u64 id;
+};
+
+// Each thread caches objects for up to POOL_THREAD_CACHES pools, keyed by pool
+// id since ids are never reused. When a thread touches one more pool the
+// oldest cache is flushed back to its pool, provided that pool still exists:
+// pools with thread_cache are listed in a registry, and holding the registry
+// lock keeps Pool_Destroy from freeing the pool during the flush.
+typedef struct PoolCache {
+    u64 pool;
+    PoolObject *free;
+    u64 count;
+} PoolCache;
+
+static atomic_ullong PoolNextId = 1;
+
+static _Thread_local PoolCache PoolThreadCaches[POOL_THREAD_CACHES];
+static _Thread_local u64 PoolThreadVictim = 0;
+
+static Pool **PoolRegistry = NULL;
+static u64 PoolRegistryCount = 0;
+static u64 PoolRegistryCapacity = 0;
+static atomic_flag PoolRegistryLock = ATOMIC_FLAG_INIT;
+
+static void
+Pool_Lock(Pool *pool)
+{
+    while (atomic_flag_test_and_set_explicit(&pool->lock, memory_order_acquire)) {
+    }
+}
+
+static void
+Pool_Unlock(Pool *pool)
+{
+    atomic_flag_clear_explicit(&pool->lock, memory_order_release);
+}
+
+static void
+Pool_LockRegistry(void)
+{
+    while (atomic_flag_test_and_set_explicit(&PoolRegistryLock, memory_order_acquire)) {
+    }
+}
+
+static void
+Pool_UnlockRegistry(void)
+{
+    atomic_flag_clear_explicit(&PoolRegistryLock, memory_order_release);
+}
+
+static void
+Pool_Register(Pool *pool)
+{
+    Pool_LockRegistry();
+
+    if (PoolRegistryCount == PoolRegistryCapacity) {
+        u64 capacity = PoolRegistryCapacity > 0 ? PoolRegistryCapacity * 2 : 16;
+        Pool **registry = realloc(PoolRegistry, sizeof(Pool *) * capacity);
+
+        if (registry == NULL) {
+            Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+        }
+
+        PoolRegistry = registry;
+        PoolRegistryCapacity = capacity;
+    }
+
+    PoolRegistry[PoolRegistryCount++] = pool;
+
+    Pool_UnlockRegistry();
+}
+
+static void
+Pool_Unregister(Pool *pool)
+{
+    Pool_LockRegistry();
+
+    for (u64 i = 0; i < PoolRegistryCount; ++i) {
+        if (PoolRegistry[i] == pool) {
+            PoolRegistry[i] = PoolRegistry[--PoolRegistryCount];
+
+            break;
+        }
+    }
+
+    if (PoolRegistryCount == 0) {
+        free(PoolRegistry);
+
+        PoolRegistry = NULL;
+        PoolRegistryCapacity = 0;
+    }
+
+    Pool_UnlockRegistry();
+}
+
+static void
+Pool_Grow(Pool *pool)
+{
+    PoolSlab *slab = malloc(sizeof(PoolSlab) + pool->object_size * pool->slab_objects);
+
+    if (slab == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    // Thread the objects in address order so consecutive allocations are
+    // adjacent in memory.
+    for (u64 i = pool->slab_objects; i > 0; --i) {
+        PoolObject *object = (PoolObject *) (void *) ((u8 *) slab->objects + (i - 1) * pool->object_size);
+
+        object->next = pool->free;
+#if defined(LIB_C_DEBUG)
+        object->stamp = POOL_FREED_STAMP;
+#endif
+        pool->free = object;
+    }
+}
+
+static inline PoolObject *
+Pool_Take(Pool *pool)
+{
+    if (pool->free == NULL) {
+        Pool_Grow(pool);
+    }
+
+    PoolObject *object = pool->free;
+
+    pool->free = object->next;
+
+    return object;
+}
+
+// Hands a thread's cached objects back to the shared free list of their pool,
+// or drops them if the pool was destroyed along with their slabs.
+static void
+Pool_Flush(PoolCache *cache)
+{
+    Pool_LockRegistry();
+
+    for (u64 i = 0; i < PoolRegistryCount; ++i) {
+        Pool *pool = PoolRegistry[i];
+
+        if (pool->id != cache->pool) {
+            continue;
+        }
+
+        Pool_Lock(pool);
+
+        while (cache->free != NULL) {
+            PoolObject *returned = cache->free;
+
+            cache->free = returned->next;
+            returned->next = pool->free;
+            pool->free = returned;
+        }
+
+        Pool_Unlock(pool);
+
+        break;
+    }
+
+    Pool_UnlockRegistry();
+
+    *cache = (PoolCache) {0};
+}
+
+static PoolCache *
+Pool_Cache(Pool *pool)
+{
+    PoolCache *empty = NULL;
+
+    for (u64 i = 0; i < POOL_THREAD_CACHES; ++i) {
+        if (PoolThreadCaches[i].pool == pool->id) {
+            return &PoolThreadCaches[i];
+        }
+
+        if (empty == NULL && PoolThreadCaches[i].pool == 0) {
+            empty = &PoolThreadCaches[i];
+        }
+    }
+
+    if (empty == NULL) {
+        empty = &PoolThreadCaches[PoolThreadVictim];
+
+        PoolThreadVictim = (PoolThreadVictim + 1) % POOL_THREAD_CACHES;
+
+        Pool_Flush(empty);
+    }
+
+    empty->pool = pool->id;
+
+    return empty;
+}
+
+static inline void
+Pool_Check(PoolObject *object, const char *function)
+{
+#if defined(LIB_C_DEBUG)
+    if (object->stamp == POOL_FREED_STAMP) {
+        Quit(-1, "%s: object %p freed twice in %s.", __FILE__, (void *) object, function);
+    }
+
+    object->stamp = POOL_FREED_STAMP;
+#else
+    UNUSED(object);
+    UNUSED(function);
+#endif
+}
+
+void
+Pool_Create(Pool **pool, PoolConfig config)
+{
+    *pool = malloc(sizeof(Pool));
+
+    if (*pool == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    u64 object_size = config.object_size;
+
+    if (object_size < sizeof(PoolObject)) {
+        object_size = sizeof(PoolObject);
+    }
+
+    (*pool)->free = NULL;
+    (*pool)->slabs = NULL;
+    (*pool)->slab_count = 0;
+    (*pool)->object_size = POOL_ALIGN(object_size);
+    (*pool)->slab_objects = config.slab_objects > 0 ? config.slab_objects : POOL_DEFAULT_SLAB_OBJECTS;
+    (*pool)->thread_cache = config.thread_cache;
+    (*pool)->id = atomic_fetch_add(&PoolNextId, 1);
+
+    atomic_flag_clear(&(*pool)->lock);
+
+    if (config.thread_cache) {
+        Pool_Register(*pool);
+    }
+}
+
+void
+Pool_Destroy(Pool **pool)
+{
+    if (pool == NULL || *pool == NULL) {
+        return;
+    }
+
+    if ((*pool)->thread_cache) {
+        Pool_Unregister(*pool);
+
+        for (u64 i = 0; i < POOL_THREAD_CACHES; ++i) {
+            if (PoolThreadCaches[i].pool == (*pool)->id) {
+                PoolThreadCaches[i] = (PoolCache) {0};
+            }
+        }
+    }
+
+    PoolSlab *slab = (*pool)->slabs;
+
+    while (slab != NULL) {
+        PoolSlab *next = slab->next;
+
+        free(slab);
+
+        slab = next;
+    }
+
+    free(*pool);
+
+    *pool = NULL;
+}
+
+void *
+Pool_Alloc(Pool *pool)
+{
+    PoolObject *object;
+
+    if (!pool->thread_cache) {
+        object = Pool_Take(pool);
+    } else {
+        PoolCache *cache = Pool_Cache(pool);
+
+        if (cache->free == NULL) {
+            Pool_Lock(pool);
+
+            for (u64 i = 0; i < POOL_CACHE_BATCH; ++i) {
+                PoolObject *taken = Pool_Take(pool);
+
+                taken->next = cache->free;
+                cache->free = taken;
+            }
+
+            Pool_Unlock(pool);
+
+            cache->count = POOL_CACHE_BATCH;
+        }
+
+        object = cache->free;
+        cache->free = object->next;
+        cache->count--;
+    }
+
+#if defined(LIB_C_DEBUG)
+    object->stamp = 0;
+#endif
+
+    return object;
+}
+
+void
+Pool_Free(Pool *pool, void *pointer)
+{
+    if (pointer == NULL) {
+        return;
+    }
+
+    PoolObject *object = pointer;
+
+    Pool_Check(object, __func__);
+
+    if (!pool->thread_cache) {
+        object->next = pool->free;
+        pool->free = object;
+
+        return;
+    }
+
+    PoolCache *cache = Pool_Cache(pool);
+
+    object->next = cache->free;
+    cache->free = object;
+    cache->count++;
+
+    if (cache->count < POOL_CACHE_BATCH * 2) {
+        return;
+    }
+
+    Pool_Lock(pool);
+
+    for (u64 i = 0; i < POOL_CACHE_BATCH; ++i) {
+        PoolObject *returned = cache->free;
+
+        cache->free = returned->next;
+        returned->next = pool->free;
+        pool->free = returned;
+    }
+
+    Pool_Unlock(pool);
+
+    cache->count -= POOL_CACHE_BATCH;
+}
+
+u64
+Pool_SlabCount(Pool *pool)
+{
+    if (!pool->thread_cache) {
+        return pool->slab_count;
+    }
+
+    Pool_Lock(pool);
+
+    u64 count = pool->slab_count;
+
+    Pool_Unlock(pool);
+
+    return count;
+}
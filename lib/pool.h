@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef POOL_H
+#define POOL_H 1
+
+// Allocator for objects of one fixed size carved out of slabs. Freed objects
+// go on an intrusive free list and are handed out again before any new slab
+// is allocated; slabs are only released by Pool_Destroy.
+//
+// With thread_cache set the pool may be used from several threads. Each
+// thread then moves objects between its own cache and the shared free list
+// in batches. A thread keeps separate caches for the last few pools it used,
+// so switching between pools doesn't strand objects; only those cached by a
+// thread that exits stay unused until Pool_Destroy. Pool_Destroy must not
+// race with other calls on the same pool.
+//
+// Debug builds detect objects freed twice.
+typedef struct Pool Pool;
+
+typedef struct PoolConfig {
+    u64 object_size;
+    u64 slab_objects;
+
+    bool thread_cache;
+} PoolConfig;
+
+#define POOL_PUSH(pool, Type) ((Type *) Pool_Alloc(pool))
+
+void Pool_Create(Pool **pool, PoolConfig config);
+void Pool_Destroy(Pool **pool);
+
+void *Pool_Alloc(Pool *pool);
+void Pool_Free(Pool *pool, void *object);
+
+// Slabs allocated so far, the pool's footprint is this times slab_objects
+// objects.
+u64 Pool_SlabCount(Pool *pool);
+
+#endif // POOL_H
@@ -0,0 +1,425 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#define SCANNER_ROWS 1024
+#define SCANNER_SYMBOLS 64
+#define SCANNER_EMPTY UINT32_MAX
+
+typedef enum {
+      SCN_LITERAL
+    , SCN_SPACE
+    , SCN_UNSIGNED
+    , SCN_SYMBOL
+    , SCN_KEYWORD
+} ScannerOpType;
+
+typedef struct ScannerOp {
+    ScannerOpType type;
+    Slice text;
+    u64 column;
+} ScannerOp;
+
+struct Scanner {
+    char *format;
+
+    ScannerOp *ops;
+    u64 op_count;
+
+    u32 **columns;
+    u64 column_count;
+    u64 rows;
+    u64 capacity;
+
+    Slice *symbols;
+    u32 symbol_count;
+    u32 symbol_capacity;
+
+    u32 *index;
+    u64 index_capacity;
+};
+
+static void *
+Scanner_Grow(void *data, u64 size)
+{
+    void *grown = realloc(data, size);
+
+    if (grown == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    return grown;
+}
+
+static u64
+Scanner_Hash(const Slice slice)
+{
+    u64 hash = 0xCBF29CE484222325ull;
+
+    for (u64 i = 0; i < slice.size; ++i) {
+        hash = (hash ^ (u8) slice.data[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+static void
+Scanner_Rehash(Scanner *scanner)
+{
+    scanner->index_capacity = scanner->index_capacity ? scanner->index_capacity * 2 : SCANNER_SYMBOLS * 2;
+    scanner->index = Scanner_Grow(NULL, sizeof(u32) * scanner->index_capacity);
+
+    for (u64 i = 0; i < scanner->index_capacity; ++i) {
+        scanner->index[i] = SCANNER_EMPTY;
+    }
+
+    u64 mask = scanner->index_capacity - 1;
+
+    for (u32 id = 0; id < scanner->symbol_count; ++id) {
+        u64 slot = Scanner_Hash(scanner->symbols[id]) & mask;
+
+        while (scanner->index[slot] != SCANNER_EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+
+        scanner->index[slot] = id;
+    }
+}
+
+static u32
+Scanner_Intern(Scanner *scanner, const Slice symbol)
+{
+    u64 mask = scanner->index_capacity - 1;
+    u64 slot = Scanner_Hash(symbol) & mask;
+
+    while (scanner->index[slot] != SCANNER_EMPTY) {
+        if (Slice_Equals(scanner->symbols[scanner->index[slot]], symbol)) {
+            return scanner->index[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    if (scanner->symbol_count == scanner->symbol_capacity) {
+        scanner->symbol_capacity *= 2;
+        scanner->symbols = Scanner_Grow(scanner->symbols, sizeof(Slice) * scanner->symbol_capacity);
+    }
+
+    u32 id = scanner->symbol_count++;
+
+    scanner->symbols[id] = symbol;
+    scanner->index[slot] = id;
+
+    if ((u64) scanner->symbol_count * 2 > scanner->index_capacity) {
+        free(scanner->index);
+
+        Scanner_Rehash(scanner);
+    }
+
+    return id;
+}
+
+static void
+Scanner_AddOp(Scanner *scanner, ScannerOpType type, Slice text)
+{
+    scanner->ops = Scanner_Grow(scanner->ops, sizeof(ScannerOp) * (scanner->op_count + 1));
+
+    ScannerOp *op = &scanner->ops[scanner->op_count++];
+
+    op->type = type;
+    op->text = text;
+    op->column = 0;
+
+    if (type != SCN_LITERAL && type != SCN_SPACE) {
+        op->column = scanner->column_count++;
+    }
+}
+
+static void
+Scanner_Compile(Scanner *scanner)
+{
+    const char *cursor = scanner->format;
+
+    while (*cursor != '\0') {
+        if (*cursor == ' ') {
+            while (*cursor == ' ') {
+                cursor++;
+            }
+
+            Scanner_AddOp(scanner, SCN_SPACE, (Slice){NULL, 0});
+        } else if (cursor[0] == '%' && cursor[1] == 'u') {
+            Scanner_AddOp(scanner, SCN_UNSIGNED, (Slice){NULL, 0});
+
+            cursor += 2;
+        } else if (cursor[0] == '%' && cursor[1] == 's') {
+            Scanner_AddOp(scanner, SCN_SYMBOL, (Slice){NULL, 0});
+
+            cursor += 2;
+        } else if (cursor[0] == '%' && cursor[1] == '{') {
+            const char *close = strchr(cursor, '}');
+
+            if (close == NULL) {
+                Quit(-1, "%s: unterminated keyword list in format '%s'.", __FILE__, scanner->format);
+            }
+
+            Scanner_AddOp(scanner, SCN_KEYWORD, (Slice){cursor + 2, (u64) (close - cursor - 2)});
+
+            cursor = close + 1;
+        } else {
+            const char *start = cursor;
+
+            if (cursor[0] == '%' && cursor[1] == '%') {
+                cursor++;
+                start = cursor;
+            }
+
+            cursor++;
+
+            while (*cursor != '\0' && *cursor != ' ' && *cursor != '%') {
+                cursor++;
+            }
+
+            Scanner_AddOp(scanner, SCN_LITERAL, (Slice){start, (u64) (cursor - start)});
+        }
+    }
+}
+
+void
+Scanner_Create(Scanner **scanner, const char *format)
+{
+    *scanner = calloc(1, sizeof(struct Scanner));
+
+    if (*scanner == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    u64 length = strlen(format);
+
+    (*scanner)->format = Scanner_Grow(NULL, length + 1);
+    memcpy((*scanner)->format, format, length + 1);
+
+    Scanner_Compile(*scanner);
+
+    (*scanner)->columns = Scanner_Grow(NULL, sizeof(u32 *) * ((*scanner)->column_count + 1));
+
+    for (u64 i = 0; i < (*scanner)->column_count; ++i) {
+        (*scanner)->columns[i] = NULL;
+    }
+
+    (*scanner)->symbol_capacity = SCANNER_SYMBOLS;
+    (*scanner)->symbols = Scanner_Grow(NULL, sizeof(Slice) * SCANNER_SYMBOLS);
+
+    Scanner_Rehash(*scanner);
+}
+
+void
+Scanner_Destroy(Scanner **scanner)
+{
+    if (scanner == NULL || *scanner == NULL) {
+        return;
+    }
+
+    for (u64 i = 0; i < (*scanner)->column_count; ++i) {
+        free((*scanner)->columns[i]);
+    }
+
+    free((*scanner)->columns);
+    free((*scanner)->ops);
+    free((*scanner)->symbols);
+    free((*scanner)->index);
+    free((*scanner)->format);
+    free(*scanner);
+
+    *scanner = NULL;
+}
+
+static bool
+Scanner_Keyword(const Slice keywords, const Slice input, u32 *index, u64 *size)
+{
+    Slice list = keywords;
+    u32 current = 0;
+    bool found = false;
+
+    while (list.data != NULL) {
+        Slice keyword = Slice_Token(&list, "|");
+
+        if (keyword.data == NULL) {
+            break;
+        }
+
+        if (Slice_StartWith(input, keyword) && (!found || keyword.size > *size)) {
+            *index = current;
+            *size = keyword.size;
+            found = true;
+        }
+
+        current++;
+    }
+
+    return found;
+}
+
+static bool
+Scanner_Line(Scanner *scanner, const Slice line, u32 *values)
+{
+    u64 position = 0;
+
+    for (u64 i = 0; i < scanner->op_count; ++i) {
+        const ScannerOp *op = &scanner->ops[i];
+        Slice rest = {line.data + position, line.size - position};
+        u64 size = 0;
+
+        switch (op->type) {
+        case SCN_LITERAL:
+            if (!Slice_StartWith(rest, op->text)) {
+                return false;
+            }
+
+            size = op->text.size;
+
+            break;
+        case SCN_SPACE:
+            while (size < rest.size && rest.data[size] == ' ') {
+                size++;
+            }
+
+            if (size == 0) {
+                return false;
+            }
+
+            break;
+        case SCN_UNSIGNED:
+            size = ParseInt_U32(rest, &values[op->column]);
+
+            if (size == 0) {
+                return false;
+            }
+
+            break;
+        case SCN_SYMBOL: {
+            const ScannerOp *next = (i + 1 < scanner->op_count) ? &scanner->ops[i + 1] : NULL;
+
+            if (next == NULL) {
+                size = rest.size;
+            } else if (next->type == SCN_LITERAL) {
+                Slice found = Slice_Find(rest, next->text);
+
+                size = (found.data == NULL) ? rest.size : (u64) (found.data - rest.data);
+            } else {
+                while (size < rest.size && rest.data[size] != ' ') {
+                    size++;
+                }
+            }
+
+            if (size == 0) {
+                return false;
+            }
+
+            values[op->column] = Scanner_Intern(scanner, (Slice){rest.data, size});
+
+            break;
+        }
+        case SCN_KEYWORD:
+            if (!Scanner_Keyword(op->text, rest, &values[op->column], &size)) {
+                return false;
+            }
+
+            break;
+        }
+
+        position += size;
+    }
+
+    return position == line.size;
+}
+
+// Parses every non-empty line of the input and appends one row per line.
+// Returns the number of rows added.
+u64
+Scanner_Parse(Scanner *scanner, const Slice input)
+{
+    u32 *values = Scanner_Grow(NULL, sizeof(u32) * (scanner->column_count + 1));
+    u64 first_row = scanner->rows;
+    u64 line_number = 0;
+
+    SliceIterator lines = Slice_Iterate(input);
+
+    while (1) {
+        Slice line = SliceIterator_NextLine(&lines);
+
+        if (line.data == NULL) {
+            break;
+        }
+
+        line_number++;
+
+        if (line.size > 0 && line.data[line.size - 1] == '\r') {
+            line.size--;
+        }
+
+        if (line.size == 0) {
+            continue;
+        }
+
+        if (!Scanner_Line(scanner, line, values)) {
+            Quit(-1, "%s: line %lu '%.*s' doesn't match format '%s'.", __FILE__,
+                line_number, (int) line.size, line.data, scanner->format
+            );
+        }
+
+        if (scanner->rows == scanner->capacity) {
+            scanner->capacity = scanner->capacity ? scanner->capacity * 2 : SCANNER_ROWS;
+
+            for (u64 i = 0; i < scanner->column_count; ++i) {
+                scanner->columns[i] = Scanner_Grow(scanner->columns[i], sizeof(u32) * scanner->capacity);
+            }
+        }
+
+        for (u64 i = 0; i < scanner->column_count; ++i) {
+            scanner->columns[i][scanner->rows] = values[i];
+        }
+
+        scanner->rows++;
+    }
+
+    free(values);
+
+    return scanner->rows - first_row;
+}
+
+u64
+Scanner_Rows(const Scanner *scanner)
+{
+    return scanner->rows;
+}
+
+u64
+Scanner_Columns(const Scanner *scanner)
+{
+    return scanner->column_count;
+}
+
+const u32 *
+Scanner_Column(const Scanner *scanner, u64 column)
+{
+    if (column >= scanner->column_count) {
+        return NULL;
+    }
+
+    return scanner->columns[column];
+}
+
+u64
+Scanner_SymbolCount(const Scanner *scanner)
+{
+    return scanner->symbol_count;
+}
+
+Slice
+Scanner_Symbol(const Scanner *scanner, u32 id)
+{
+    if (id >= scanner->symbol_count) {
+        return (Slice){NULL, 0};
+    }
+
+    return scanner->symbols[id];
+}
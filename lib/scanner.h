@@ -0,0 +1,26 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef SCANNER_H
+#define SCANNER_H 1
+
+// Format conversions, each one producing a u32 column:
+//     %u          unsigned integer
+//     %s          symbol, interned into an id (see Scanner_Symbol)
+//     %{a|b|c}    keyword, stored as the index of the matched alternative
+// A space matches one or more spaces and any other character matches
+// itself. Symbols point into the parsed input, which must outlive the
+// scanner.
+
+typedef struct Scanner Scanner;
+
+void Scanner_Create(Scanner **scanner, const char *format);
+void Scanner_Destroy(Scanner **scanner);
+u64 Scanner_Parse(Scanner *scanner, const Slice input);
+u64 Scanner_Rows(const Scanner *scanner);
+u64 Scanner_Columns(const Scanner *scanner);
+const u32 *Scanner_Column(const Scanner *scanner, u64 column);
+u64 Scanner_SymbolCount(const Scanner *scanner);
+Slice Scanner_Symbol(const Scanner *scanner, u32 id);
+
+#endif // SCANNER_H
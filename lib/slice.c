@@ -1,11 +1,271 @@
 // Copyright (c) 2022 Gustavo Ribeiro Croscato
 // SPDX-License-Identifier: MIT
 
-#define SLICE_BUFFER_SIZE 64 * 1024
-
-static char SliceBuffer[SLICE_BUFFER_SIZE];
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+#define SLICE_READ_SIZE (64 * 1024)
+#define SLICE_READER_SIZE (4 * 1024 * 1024)
+#define SLICE_LINES_SIZE 1024
+
+typedef struct SliceRegion {
+    void *base;
+    u64 length;
+    bool mapped;
+
+    struct SliceRegion *next;
+} SliceRegion;
+
+struct SliceReader {
+    char *buffer[2];
+    u64 capacity;
+    u64 carry;
+
+    int fd;
+    u8 current;
+    bool eof;
+    bool owns_fd;
+};
+
+static SliceRegion *SliceRegions = NULL;
 static const Slice NullSlice = {NULL, 0};
 
+static void
+Slice_TrackRegion(void *base, u64 length, bool mapped)
+{
+    SliceRegion *region = malloc(sizeof(SliceRegion));
+
+    if (region == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    region->base = base;
+    region->length = length;
+    region->mapped = mapped;
+    region->next = SliceRegions;
+
+    SliceRegions = region;
+}
+
+// Regular files are mapped copy-on-write, so pages the solver only reads
+// stay shared with the page cache. The byte after the last one is always
+// '\0': either the zero fill of the last page or an extra anonymous page
+// when the file size is page aligned.
+static Slice
+Slice_MapRegular(int fd, u64 size)
+{
+    u64 page_size = (u64) sysconf(_SC_PAGESIZE);
+    u64 length = size;
+    char *base;
+
+    if (size % page_size == 0) {
+        length += page_size;
+
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (base == MAP_FAILED) {
+            goto map_error;
+        }
+
+        if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(base, length);
+
+            goto map_error;
+        }
+    } else {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        if (base == MAP_FAILED) {
+            goto map_error;
+        }
+    }
+
+    madvise(base, size, MADV_SEQUENTIAL);
+
+    Slice_TrackRegion(base, length, true);
+
+    return (Slice){base, size};
+
+map_error:
+    Quit(-1, "%s: can't map input (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+}
+
+static Slice
+Slice_ReadStream(int fd)
+{
+    u64 capacity = SLICE_READ_SIZE;
+    u64 size = 0;
+    char *buffer = malloc(capacity);
+
+    if (buffer == NULL) {
+        goto out_of_memory;
+    }
+
+    while (1) {
+        if (capacity - size < SLICE_READ_SIZE + 1) {
+            capacity *= 2;
+
+            char *grown = realloc(buffer, capacity);
+
+            if (grown == NULL) {
+                free(buffer);
+
+                goto out_of_memory;
+            }
+
+            buffer = grown;
+        }
+
+        ssize_t bytes_read = read(fd, buffer + size, capacity - size - 1);
+
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            free(buffer);
+
+            Quit(-1, "%s: can't read input (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+        }
+
+        if (bytes_read == 0) {
+            break;
+        }
+
+        size += (u64) bytes_read;
+    }
+
+    if (size == 0) {
+        free(buffer);
+
+        return NullSlice;
+    }
+
+    buffer[size] = '\0';
+
+    Slice_TrackRegion(buffer, capacity, false);
+
+    return (Slice){buffer, size};
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+static Slice
+Slice_MapDescriptor(int fd)
+{
+    struct stat info;
+
+    if (fstat(fd, &info) != 0) {
+        Quit(-1, "%s: can't stat input (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+    }
+
+    if (!S_ISREG(info.st_mode)) {
+        return Slice_ReadStream(fd);
+    }
+
+    if (info.st_size == 0) {
+        return NullSlice;
+    }
+
+    return Slice_MapRegular(fd, (u64) info.st_size);
+}
+
+// Bounded memmem. The SIMD path compares the first and last needle bytes
+// against a whole block of candidate positions and only runs memcmp on the
+// positions where both match.
+static const char *
+Slice_Search(const char *haystack, u64 haystack_size, const char *needle, u64 needle_size)
+{
+    if (needle_size == 0) {
+        return haystack;
+    }
+
+    if (needle_size > haystack_size) {
+        return NULL;
+    }
+
+    if (needle_size == 1) {
+        return memchr(haystack, needle[0], haystack_size);
+    }
+
+    u64 last = needle_size - 1;
+    u64 candidates = haystack_size - last;
+    u64 position = 0;
+
+#if defined(__AVX2__)
+    const __m256i first_byte = _mm256_set1_epi8(needle[0]);
+    const __m256i last_byte = _mm256_set1_epi8(needle[last]);
+
+    for (; position + 32 <= candidates; position += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *) (haystack + position));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *) (haystack + position + last));
+
+        u32 mask = (u32) _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block_first, first_byte),
+            _mm256_cmpeq_epi8(block_last, last_byte)
+        ));
+
+        while (mask) {
+            const char *candidate = haystack + position + __builtin_ctz(mask);
+
+            if (memcmp(candidate + 1, needle + 1, last - 1) == 0) {
+                return candidate;
+            }
+
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i first_byte = _mm_set1_epi8(needle[0]);
+    const __m128i last_byte = _mm_set1_epi8(needle[last]);
+
+    for (; position + 16 <= candidates; position += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *) (haystack + position));
+        __m128i block_last = _mm_loadu_si128((const __m128i *) (haystack + position + last));
+
+        u32 mask = (u32) _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block_first, first_byte),
+            _mm_cmpeq_epi8(block_last, last_byte)
+        ));
+
+        while (mask) {
+            const char *candidate = haystack + position + __builtin_ctz(mask);
+
+            if (memcmp(candidate + 1, needle + 1, last - 1) == 0) {
+                return candidate;
+            }
+
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (position < candidates) {
+        const char *candidate = memchr(haystack + position, needle[0], candidates - position);
+
+        if (candidate == NULL) {
+            return NULL;
+        }
+
+        if (candidate[last] == needle[last] && memcmp(candidate + 1, needle + 1, last - 1) == 0) {
+            return candidate;
+        }
+
+        position = (u64) (candidate - haystack) + 1;
+    }
+
+    return NULL;
+}
+
 bool
 Slice_Equals(const Slice lhs, const Slice rhs)
 {
@@ -59,7 +319,7 @@ Slice_Contains(const Slice slice, const Slice subslice)
         return false;
     }
 
-    return strstr(slice.data, subslice.data) != NULL;
+    return Slice_Search(slice.data, slice.size, subslice.data, subslice.size) != NULL;
 }
 
 bool
@@ -109,7 +369,7 @@ Slice_Find(const Slice slice, const Slice subslice)
         return NullSlice;
     }
 
-    const char *cursor = strstr(slice.data, subslice.data);
+    const char *cursor = Slice_Search(slice.data, slice.size, subslice.data, subslice.size);
 
     if (cursor == NULL) {
         return NullSlice;
@@ -131,7 +391,7 @@ Slice_ReadLine(Slice *slice)
         return NullSlice;
     }
 
-    char *cursor = SliceBuffer + (slice->data - SliceBuffer);
+    char *cursor = (char *) (uintptr_t) slice->data;
     u64 available = slice->size;
 
     u64 new_size = 0;
@@ -164,21 +424,31 @@ Slice_ReadLine(Slice *slice)
 }
 
 Slice
-Slice_ReadStdIn(void)
+Slice_MapFile(const char *path)
 {
-    u64 bytes_read = fread(SliceBuffer, 1, SLICE_BUFFER_SIZE, stdin);
+    int fd = open(path, O_RDONLY);
 
-    if (bytes_read == SLICE_BUFFER_SIZE) {
-        Quit(-1, "StdIn_ReadLine: buffer overflow.\n");
+    if (fd < 0) {
+        Quit(-1, "%s: can't open '%s' (%s).", __FILE__, path, strerror(errno));
     }
 
-    if (bytes_read == 0) {
-        return NullSlice;
-    }
+    Slice result = Slice_MapDescriptor(fd);
 
-    SliceBuffer[bytes_read] = '\0';
+    close(fd);
 
-    return (Slice){SliceBuffer, bytes_read};
+    return result;
+}
+
+Slice
+Slice_MapStdIn(void)
+{
+    return Slice_MapDescriptor(STDIN_FILENO);
+}
+
+Slice
+Slice_ReadStdIn(void)
+{
+    return Slice_MapStdIn();
 }
 
 Slice
@@ -199,7 +469,13 @@ Slice_Token(Slice *slice, const char *delimiter)
         return NullSlice;
     }
 
-    const char *cursor = strstr(slice->data, delimiter);
+    const char *cursor;
+
+    if (delimiter_length == 1) {
+        cursor = memchr(slice->data, delimiter[0], slice->size);
+    } else {
+        cursor = Slice_Search(slice->data, slice->size, delimiter, delimiter_length);
+    }
 
     Slice result = {.data = slice->data};
 
@@ -218,6 +494,174 @@ Slice_Token(Slice *slice, const char *delimiter)
     return result;
 }
 
+static u8
+Slice_HexValue(char ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return (u8) (ch - '0');
+    }
+
+    return (u8) ((ch | 0x20) - 'a' + 10);
+}
+
+// Offset of the first byte at or after position that needs escaping (the
+// '"' and '\\' bytes), or size when there is none. Blocks without special
+// bytes are skipped 32 or 16 bytes at a time.
+static u64
+Slice_FindSpecial(const char *data, u64 size, u64 position, bool quotes)
+{
+#if defined(__AVX2__)
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i quote = _mm256_set1_epi8(quotes ? '"' : '\\');
+
+    for (; position + 32 <= size; position += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (data + position));
+        u32 mask = (u32) _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_cmpeq_epi8(block, backslash),
+            _mm256_cmpeq_epi8(block, quote)
+        ));
+
+        if (mask) {
+            return position + (u64) __builtin_ctz(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i quote = _mm_set1_epi8(quotes ? '"' : '\\');
+
+    for (; position + 16 <= size; position += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (data + position));
+        u32 mask = (u32) _mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(block, backslash),
+            _mm_cmpeq_epi8(block, quote)
+        ));
+
+        if (mask) {
+            return position + (u64) __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; position < size; ++position) {
+        if (data[position] == '\\' || (quotes && data[position] == '"')) {
+            return position;
+        }
+    }
+
+    return size;
+}
+
+// Decodes the body of a string literal (without the surrounding quotes)
+// with the \\, \" and \xHH escapes. Returns the decoded length and, when
+// output is not NULL, writes the decoded bytes there. Any other escape,
+// including a trailing '\\' or \x without two hex digits, returns
+// SLICE_INVALID. Runs without escapes are skipped a vector at a time and
+// copied with memcpy.
+u64
+Slice_Unescape(const Slice slice, char *output)
+{
+    if (slice.data == NULL) {
+        return 0;
+    }
+
+    u64 length = 0;
+    u64 position = 0;
+
+    while (position < slice.size) {
+        u64 special = Slice_FindSpecial(slice.data, slice.size, position, false);
+
+        if (output != NULL) {
+            memcpy(output + length, slice.data + position, special - position);
+        }
+
+        length += special - position;
+        position = special;
+
+        if (position == slice.size) {
+            break;
+        }
+
+        if (position + 1 == slice.size) {
+            return SLICE_INVALID;
+        }
+
+        char next = slice.data[position + 1];
+        char decoded;
+        u64 consumed;
+
+        if (next == '\\' || next == '"') {
+            decoded = next;
+            consumed = 2;
+        } else if (
+            next == 'x' &&
+            position + 3 < slice.size &&
+            isxdigit((u8) slice.data[position + 2]) &&
+            isxdigit((u8) slice.data[position + 3])
+        ) {
+            decoded = (char) ((Slice_HexValue(slice.data[position + 2]) << 4) | Slice_HexValue(slice.data[position + 3]));
+            consumed = 4;
+        } else {
+            return SLICE_INVALID;
+        }
+
+        if (output != NULL) {
+            output[length] = decoded;
+        }
+
+        length++;
+        position += consumed;
+    }
+
+    return length;
+}
+
+// Encodes the slice as a string literal, surrounding quotes included, by
+// escaping every '"' and '\\'. Returns the encoded length and, when output
+// is not NULL, writes the encoded bytes there.
+u64
+Slice_Escape(const Slice slice, char *output)
+{
+    if (slice.data == NULL) {
+        return 0;
+    }
+
+    u64 length = 1;
+    u64 position = 0;
+
+    if (output != NULL) {
+        output[0] = '"';
+    }
+
+    while (position < slice.size) {
+        u64 special = Slice_FindSpecial(slice.data, slice.size, position, true);
+
+        if (output != NULL) {
+            memcpy(output + length, slice.data + position, special - position);
+        }
+
+        length += special - position;
+        position = special;
+
+        if (position == slice.size) {
+            break;
+        }
+
+        if (output != NULL) {
+            output[length] = '\\';
+            output[length + 1] = slice.data[position];
+        }
+
+        length += 2;
+        position++;
+    }
+
+    if (output != NULL) {
+        output[length] = '"';
+    }
+
+    return length + 1;
+}
+
 void
 Slice_Print(Slice slice)
 {
@@ -228,3 +672,341 @@ Slice_Print(Slice slice)
     }
 }
 
+void
+Slice_Unmap(Slice slice)
+{
+    SliceRegion *region = SliceRegions;
+    SliceRegion *parent = NULL;
+
+    while (region != NULL) {
+        if (region->base == slice.data) {
+            break;
+        }
+
+        parent = region;
+        region = region->next;
+    }
+
+    if (region == NULL) {
+        return;
+    }
+
+    if (parent) {
+        parent->next = region->next;
+    } else {
+        SliceRegions = region->next;
+    }
+
+    if (region->mapped) {
+        munmap(region->base, region->length);
+    } else {
+        free(region->base);
+    }
+
+    free(region);
+}
+
+SliceIterator
+Slice_Iterate(const Slice slice)
+{
+    if (slice.data == NULL) {
+        return (SliceIterator){NULL, NULL};
+    }
+
+    return (SliceIterator){slice.data, slice.data + slice.size};
+}
+
+Slice
+SliceIterator_NextLine(SliceIterator *iterator)
+{
+    if (iterator == NULL || iterator->cursor == NULL || iterator->cursor == iterator->end) {
+        return NullSlice;
+    }
+
+    const char *start = iterator->cursor;
+    const char *newline = memchr(start, '\n', (u64) (iterator->end - start));
+
+    if (newline == NULL) {
+        iterator->cursor = iterator->end;
+
+        return (Slice){start, (u64) (iterator->end - start)};
+    }
+
+    iterator->cursor = newline + 1;
+
+    return (Slice){start, (u64) (newline - start)};
+}
+
+static void
+SliceLines_Push(SliceLines *lines, u64 *capacity, u64 offset)
+{
+    if (lines->count + 1 == *capacity) {
+        *capacity *= 2;
+
+        u64 *grown = realloc(lines->offset, sizeof(u64) * *capacity);
+
+        if (grown == NULL) {
+            Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+        }
+
+        lines->offset = grown;
+    }
+
+    lines->offset[++lines->count] = offset;
+}
+
+// offset[i] is where line i starts and offset[count] is one past the
+// terminator of the last line, so line i spans offset[i] to
+// offset[i + 1] - 1 and both parts can walk the table without rescanning.
+SliceLines
+Slice_SplitLines(const Slice slice)
+{
+    SliceLines lines = {slice.data, NULL, 0};
+
+    if (slice.data == NULL || slice.size == 0) {
+        return lines;
+    }
+
+    u64 capacity = slice.size / 32 + SLICE_LINES_SIZE;
+
+    lines.offset = malloc(sizeof(u64) * capacity);
+
+    if (lines.offset == NULL) {
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+    }
+
+    lines.offset[0] = 0;
+
+    u64 position = 0;
+
+#if defined(__AVX2__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    for (; position + 32 <= slice.size; position += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (slice.data + position));
+        u32 mask = (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+
+        while (mask) {
+            SliceLines_Push(&lines, &capacity, position + (u64) __builtin_ctz(mask) + 1);
+
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; position + 16 <= slice.size; position += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (slice.data + position));
+        u32 mask = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+
+        while (mask) {
+            SliceLines_Push(&lines, &capacity, position + (u64) __builtin_ctz(mask) + 1);
+
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; position < slice.size; ++position) {
+        if (slice.data[position] == '\n') {
+            SliceLines_Push(&lines, &capacity, position + 1);
+        }
+    }
+
+    if (lines.offset[lines.count] != slice.size) {
+        SliceLines_Push(&lines, &capacity, slice.size + 1);
+    }
+
+    return lines;
+}
+
+Slice
+SliceLines_Get(const SliceLines lines, u64 index)
+{
+    if (index >= lines.count) {
+        return NullSlice;
+    }
+
+    return (Slice){
+        lines.data + lines.offset[index],
+        lines.offset[index + 1] - lines.offset[index] - 1
+    };
+}
+
+void
+SliceLines_Destroy(SliceLines *lines)
+{
+    if (lines == NULL) {
+        return;
+    }
+
+    free(lines->offset);
+
+    lines->data = NULL;
+    lines->offset = NULL;
+    lines->count = 0;
+}
+
+static void
+SliceReader_Create(SliceReader **reader, int fd, bool owns_fd, u64 chunk_size)
+{
+    *reader = malloc(sizeof(struct SliceReader));
+
+    if (*reader == NULL) {
+        goto out_of_memory;
+    }
+
+    if (chunk_size == 0) {
+        chunk_size = SLICE_READER_SIZE;
+    }
+
+    (*reader)->buffer[0] = malloc(chunk_size + 1);
+    (*reader)->buffer[1] = malloc(chunk_size + 1);
+
+    if ((*reader)->buffer[0] == NULL || (*reader)->buffer[1] == NULL) {
+        goto out_of_memory;
+    }
+
+    (*reader)->capacity = chunk_size;
+    (*reader)->carry = 0;
+    (*reader)->fd = fd;
+    (*reader)->current = 0;
+    (*reader)->eof = false;
+    (*reader)->owns_fd = owns_fd;
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    return;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+static void
+SliceReader_Grow(SliceReader *reader)
+{
+    u64 capacity = reader->capacity * 2;
+
+    for (int i = 0; i < 2; ++i) {
+        char *grown = realloc(reader->buffer[i], capacity + 1);
+
+        if (grown == NULL) {
+            Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+        }
+
+        reader->buffer[i] = grown;
+    }
+
+    reader->capacity = capacity;
+}
+
+void
+SliceReader_Open(SliceReader **reader, const char *path, u64 chunk_size)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        Quit(-1, "%s: can't open '%s' (%s).", __FILE__, path, strerror(errno));
+    }
+
+    SliceReader_Create(reader, fd, true, chunk_size);
+}
+
+void
+SliceReader_OpenStdIn(SliceReader **reader, u64 chunk_size)
+{
+    SliceReader_Attach(reader, STDIN_FILENO, chunk_size);
+}
+
+void
+SliceReader_Attach(SliceReader **reader, int fd, u64 chunk_size)
+{
+    SliceReader_Create(reader, fd, false, chunk_size);
+}
+
+// Returns the next run of whole lines, '\0' terminated. The partial line at
+// the end of the read is copied to the front of the other buffer, so the
+// returned window stays valid until the following call. A buffer only
+// grows when a single line does not fit in it.
+Slice
+SliceReader_Next(SliceReader *reader)
+{
+    if (reader == NULL) {
+        return NullSlice;
+    }
+
+    char *buffer = reader->buffer[reader->current];
+    u64 size = reader->carry;
+    u64 end;
+
+    while (1) {
+        while (!reader->eof && size < reader->capacity) {
+            ssize_t bytes_read = read(reader->fd, buffer + size, reader->capacity - size);
+
+            if (bytes_read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                Quit(-1, "%s: can't read input (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+            }
+
+            if (bytes_read == 0) {
+                reader->eof = true;
+            }
+
+            size += (u64) bytes_read;
+        }
+
+        if (reader->eof) {
+            end = size;
+
+            break;
+        }
+
+        end = size;
+
+        while (end > 0 && buffer[end - 1] != '\n') {
+            end--;
+        }
+
+        if (end > 0) {
+            break;
+        }
+
+        SliceReader_Grow(reader);
+
+        buffer = reader->buffer[reader->current];
+    }
+
+    if (size == 0) {
+        return NullSlice;
+    }
+
+    reader->carry = size - end;
+    reader->current ^= 1;
+
+    memcpy(reader->buffer[reader->current], buffer + end, reader->carry);
+
+    buffer[end] = '\0';
+
+    return (Slice){buffer, end};
+}
+
+void
+SliceReader_Close(SliceReader **reader)
+{
+    if (reader == NULL || *reader == NULL) {
+        return;
+    }
+
+    if ((*reader)->owns_fd) {
+        close((*reader)->fd);
+    }
+
+    free((*reader)->buffer[0]);
+    free((*reader)->buffer[1]);
+    free(*reader);
+
+    *reader = NULL;
+}
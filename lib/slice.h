@@ -4,11 +4,27 @@
 #ifndef SLICE_H
 #define SLICE_H 1
 
+// Returned by Slice_Unescape for a malformed escape sequence.
+#define SLICE_INVALID UINT64_MAX
+
 typedef struct {
     const char *data;
     u64 size;
 } Slice;
 
+typedef struct SliceLines {
+    const char *data;
+    u64 *offset;
+    u64 count;
+} SliceLines;
+
+typedef struct SliceIterator {
+    const char *cursor;
+    const char *end;
+} SliceIterator;
+
+typedef struct SliceReader SliceReader;
+
 bool Slice_Equals(const Slice lhs, const Slice rhs);
 bool Slice_StartWith(const Slice slice, const Slice subslice);
 bool Slice_EndWith(const Slice slice, const Slice subslice);
@@ -22,9 +38,27 @@ int Slice_CompareStr(const Slice lhs, const char *data);
 Slice Slice_Find(const Slice slice, const Slice subslice);
 Slice Slice_FindStr(const Slice slice, const char *data);
 Slice Slice_ReadLine(Slice *slice);
+Slice Slice_MapFile(const char *path);
+Slice Slice_MapStdIn(void);
 Slice Slice_ReadStdIn(void);
 Slice Slice_Token(Slice *slice, const char *delimiter);
+u64 Slice_Unescape(const Slice slice, char *output);
+u64 Slice_Escape(const Slice slice, char *output);
 void Slice_Print(Slice slice);
+void Slice_Unmap(Slice slice);
+
+SliceIterator Slice_Iterate(const Slice slice);
+Slice SliceIterator_NextLine(SliceIterator *iterator);
+
+SliceLines Slice_SplitLines(const Slice slice);
+Slice SliceLines_Get(const SliceLines lines, u64 index);
+void SliceLines_Destroy(SliceLines *lines);
+
+void SliceReader_Open(SliceReader **reader, const char *path, u64 chunk_size);
+void SliceReader_OpenStdIn(SliceReader **reader, u64 chunk_size);
+void SliceReader_Attach(SliceReader **reader, int fd, u64 chunk_size);
+Slice SliceReader_Next(SliceReader *reader);
+void SliceReader_Close(SliceReader **reader);
 
 #endif // SLICE_H
 
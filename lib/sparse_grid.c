@@ -0,0 +1,166 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#define SPARSE_GRID_INITIAL_TILES 16
+#define SPARSE_GRID_TILE_HASH(key) (key)
+#define SPARSE_GRID_TILE_EQUALS(left, right) ((left) == (right))
+
+typedef struct SparseGridTile {
+    u64 rows[SPARSE_GRID_TILE_SIZE];
+} SparseGridTile;
+
+DEFINE_MAP(SparseGridTileMap, u64, u32, SPARSE_GRID_TILE_HASH, SPARSE_GRID_TILE_EQUALS)
+
+struct SparseGrid {
+    SparseGridTile *tiles;
+    u64 count;
+    u64 capacity;
+
+    SparseGridTileMap *index;
+
+    // Walks mostly stay inside one tile, so the last tile skips the lookup.
+    u64 last_key;
+    SparseGridTile *last_tile;
+};
+
+static inline u64
+SparseGrid_TileKey(u32 x, u32 y)
+{
+    return ((u64) (x / SPARSE_GRID_TILE_SIZE) << 32) | (u64) (y / SPARSE_GRID_TILE_SIZE);
+}
+
+// Cells are biased to unsigned so tiles split evenly around zero.
+static inline u32
+SparseGrid_Bias(i32 value)
+{
+    return (u32) value ^ 0x80000000U;
+}
+
+static SparseGridTile *
+SparseGrid_Tile(const SparseGrid *grid, u64 key)
+{
+    if (grid->last_tile != NULL && grid->last_key == key) {
+        return grid->last_tile;
+    }
+
+    u32 *index = SparseGridTileMap_Find(grid->index, key);
+
+    return index == NULL ? NULL : &grid->tiles[*index];
+}
+
+void
+SparseGrid_Create(SparseGrid **grid)
+{
+    *grid = malloc(sizeof(SparseGrid));
+
+    if (*grid == NULL) {
+        goto out_of_memory;
+    }
+
+    (*grid)->tiles = malloc(sizeof(SparseGridTile) * SPARSE_GRID_INITIAL_TILES);
+
+    if ((*grid)->tiles == NULL) {
+        goto out_of_memory;
+    }
+
+    (*grid)->count = 0;
+    (*grid)->capacity = SPARSE_GRID_INITIAL_TILES;
+    (*grid)->last_key = 0;
+    (*grid)->last_tile = NULL;
+
+    SparseGridTileMap_Create(&(*grid)->index, SPARSE_GRID_INITIAL_TILES);
+
+    return;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+void
+SparseGrid_Destroy(SparseGrid **grid)
+{
+    if (grid == NULL || *grid == NULL) {
+        return;
+    }
+
+    SparseGridTileMap_Destroy(&(*grid)->index);
+
+    free((*grid)->tiles);
+    free(*grid);
+
+    *grid = NULL;
+}
+
+bool
+SparseGrid_SetIfUnset(SparseGrid *grid, i32 x, i32 y)
+{
+    u32 column = SparseGrid_Bias(x);
+    u32 row = SparseGrid_Bias(y);
+    u64 key = SparseGrid_TileKey(column, row);
+
+    SparseGridTile *tile = SparseGrid_Tile(grid, key);
+
+    if (tile == NULL) {
+        if (grid->count == grid->capacity) {
+            SparseGridTile *tiles = realloc(grid->tiles, sizeof(SparseGridTile) * grid->capacity * 2);
+
+            if (tiles == NULL) {
+                Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+            }
+
+            grid->tiles = tiles;
+            grid->capacity *= 2;
+        }
+
+        tile = &grid->tiles[grid->count];
+
+        memset(tile, 0, sizeof(SparseGridTile));
+
+        SparseGridTileMap_Insert(grid->index, key, (u32) grid->count);
+
+        grid->count++;
+    }
+
+    grid->last_key = key;
+    grid->last_tile = tile;
+
+    u64 *cells = &tile->rows[row % SPARSE_GRID_TILE_SIZE];
+    u64 bit = (u64) 1 << (column % SPARSE_GRID_TILE_SIZE);
+
+    if (*cells & bit) {
+        return false;
+    }
+
+    *cells |= bit;
+
+    return true;
+}
+
+bool
+SparseGrid_Get(const SparseGrid *grid, i32 x, i32 y)
+{
+    u32 column = SparseGrid_Bias(x);
+    u32 row = SparseGrid_Bias(y);
+
+    const SparseGridTile *tile = SparseGrid_Tile(grid, SparseGrid_TileKey(column, row));
+
+    if (tile == NULL) {
+        return false;
+    }
+
+    return (tile->rows[row % SPARSE_GRID_TILE_SIZE] >> (column % SPARSE_GRID_TILE_SIZE)) & 1;
+}
+
+u64
+SparseGrid_Count(const SparseGrid *grid)
+{
+    u64 count = 0;
+
+    for (u64 i = 0; i < grid->count; ++i) {
+        for (u64 row = 0; row < SPARSE_GRID_TILE_SIZE; ++row) {
+            count += (u64) __builtin_popcountll(grid->tiles[i].rows[row]);
+        }
+    }
+
+    return count;
+}
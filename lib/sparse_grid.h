@@ -0,0 +1,22 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef SPARSE_GRID_H
+#define SPARSE_GRID_H 1
+
+// Unbounded set of 2D cells stored as one bit per cell in square tiles of
+// SPARSE_GRID_TILE_SIZE cells a side. A tile is allocated the first time one
+// of its cells is set.
+#define SPARSE_GRID_TILE_SIZE 64
+
+typedef struct SparseGrid SparseGrid;
+
+void SparseGrid_Create(SparseGrid **grid);
+void SparseGrid_Destroy(SparseGrid **grid);
+
+// Returns true when the cell was not set before.
+bool SparseGrid_SetIfUnset(SparseGrid *grid, i32 x, i32 y);
+bool SparseGrid_Get(const SparseGrid *grid, i32 x, i32 y);
+u64 SparseGrid_Count(const SparseGrid *grid);
+
+#endif // SPARSE_GRID_H
@@ -1,42 +1,107 @@
 // Copyright (c) 2022 Gustavo Ribeiro Croscato
 // SPDX-License-Identifier: MIT
 
-#define LINE_SIZE 32 * 1024
+#define STDIN_BUFFER_SIZE (64 * 1024)
 
 const char *DebugFile = NULL;
 const char *DebugFunction = NULL;
 u64 DebugLine = 0;
 
-static char line[LINE_SIZE];
+static char *StdInBuffer = NULL;
+static u64 StdInCapacity = 0;
+static u64 StdInStart = 0;
+static u64 StdInEnd = 0;
+static bool StdInEOF = false;
 
-const char *
+static void
+StdIn_Fill(void)
+{
+    if (StdInBuffer == NULL) {
+        StdInCapacity = STDIN_BUFFER_SIZE;
+        StdInBuffer = malloc(StdInCapacity);
+
+        if (StdInBuffer == NULL) {
+            goto out_of_memory;
+        }
+    }
+
+    if (StdInStart > 0) {
+        memmove(StdInBuffer, StdInBuffer + StdInStart, StdInEnd - StdInStart);
+
+        StdInEnd -= StdInStart;
+        StdInStart = 0;
+    }
+
+    if (StdInEnd + 1 == StdInCapacity) {
+        char *grown = realloc(StdInBuffer, StdInCapacity * 2);
+
+        if (grown == NULL) {
+            goto out_of_memory;
+        }
+
+        StdInBuffer = grown;
+        StdInCapacity *= 2;
+    }
+
+    u64 bytes_read = fread(StdInBuffer + StdInEnd, 1, StdInCapacity - StdInEnd - 1, stdin);
+
+    if (bytes_read == 0) {
+        if (ferror(stdin)) {
+            Quit(-1, "%s: can't read input (%s) in %s at line %d.", __FILE__, strerror(errno), __func__, __LINE__);
+        }
+
+        StdInEOF = true;
+    }
+
+    StdInEnd += bytes_read;
+
+    return;
+
+out_of_memory:
+    Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__);
+}
+
+// Returns the next line without its '\n', '\0' terminated, or a NULL slice
+// at the end of the input. The line is valid until the next call.
+Slice
 StdIn_ReadLine(void)
 {
-    char *result = line;
-    int ch;
-    u64 size = LINE_SIZE;
+    u64 scanned = 0;
 
-    while ((ch = fgetc(stdin)) != EOF && size != 0) {
-        if (ch == '\n') {
+    while (1) {
+        if (StdInEnd - StdInStart > scanned) {
+            char *cursor = StdInBuffer + StdInStart;
+            char *newline = memchr(cursor + scanned, '\n', StdInEnd - StdInStart - scanned);
+
+            if (newline != NULL) {
+                Slice result = {cursor, (u64) (newline - cursor)};
+
+                *newline = '\0';
+                StdInStart += result.size + 1;
+
+                return result;
+            }
+
+            scanned = StdInEnd - StdInStart;
+        }
+
+        if (StdInEOF) {
             break;
         }
 
-        *result++ = (char) ch;
-        size--;
+        StdIn_Fill();
     }
 
-    if (size == 0) {
-        fprintf(stderr, "StdIn_ReadLine: buffer overflow.\n");
-        exit(1);
+    if (StdInStart == StdInEnd) {
+        return (Slice){NULL, 0};
     }
 
-    *result = '\0';
+    Slice result = {StdInBuffer + StdInStart, StdInEnd - StdInStart};
 
-    if (ch == EOF && result == line) {
-        return NULL;
-    }
+    StdInBuffer[StdInEnd] = '\0';
+    StdInStart = StdInEnd;
 
-    return line;
+    return result;
 }
 
 _Noreturn void
@@ -17,7 +17,7 @@ extern u64 DebugLine;
     goto tag;                 \
 }
 
-const char *StdIn_ReadLine(void);
+Slice StdIn_ReadLine(void);
 
 _Noreturn void Quit(int code, const char *msg, ...);
 
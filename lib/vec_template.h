@@ -0,0 +1,133 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+#ifndef VEC_TEMPLATE_H
+#define VEC_TEMPLATE_H 1
+
+#define VEC_MIN_CAPACITY 8
+
+typedef int (*VecCompare)(const void *left, const void *right);
+
+// Defines Name, a growable contiguous array of Type. items and count may be
+// read directly; pointers into items stay valid until the array grows.
+//
+//     DEFINE_VEC(CommandVec, Command)
+//
+// defines CommandVec_Create, _Destroy, _Reserve, _Push, _Pop, _Get,
+// _SwapRemove, _Clear and _Sort. _SwapRemove moves the last item into the
+// removed slot, so it is O(1) but does not keep the order. _Sort takes a
+// qsort comparator.
+#define DEFINE_VEC(Name, Type)                                                  \
+typedef struct Name {                                                           \
+    Type *items;                                                                \
+    u64 count;                                                                  \
+    u64 capacity;                                                               \
+} Name;                                                                         \
+                                                                                \
+static inline void                                                              \
+Name##_Reserve(Name *vec, u64 capacity)                                         \
+{                                                                               \
+    if (capacity <= vec->capacity) {                                            \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    u64 grown = vec->capacity < VEC_MIN_CAPACITY ? VEC_MIN_CAPACITY : vec->capacity; \
+                                                                                \
+    while (grown < capacity) {                                                  \
+        grown *= 2;                                                             \
+    }                                                                           \
+                                                                                \
+    Type *items = realloc(vec->items, sizeof(Type) * grown);                    \
+                                                                                \
+    if (items == NULL) {                                                        \
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__); \
+    }                                                                           \
+                                                                                \
+    vec->items = items;                                                         \
+    vec->capacity = grown;                                                      \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Create(Name **vec, u64 capacity)                                         \
+{                                                                               \
+    *vec = malloc(sizeof(Name));                                                \
+                                                                                \
+    if (*vec == NULL) {                                                         \
+        Quit(-1, "%s: out of memory in %s at line %d.", __FILE__, __func__, __LINE__); \
+    }                                                                           \
+                                                                                \
+    (*vec)->items = NULL;                                                       \
+    (*vec)->count = 0;                                                          \
+    (*vec)->capacity = 0;                                                       \
+                                                                                \
+    Name##_Reserve(*vec, capacity);                                             \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Destroy(Name **vec)                                                      \
+{                                                                               \
+    if (vec == NULL || *vec == NULL) {                                          \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    free((*vec)->items);                                                        \
+    free(*vec);                                                                 \
+                                                                                \
+    *vec = NULL;                                                                \
+}                                                                               \
+                                                                                \
+static inline Type *                                                            \
+Name##_Push(Name *vec, Type item)                                               \
+{                                                                               \
+    if (vec->count == vec->capacity) {                                          \
+        Name##_Reserve(vec, vec->count + 1);                                    \
+    }                                                                           \
+                                                                                \
+    vec->items[vec->count] = item;                                              \
+                                                                                \
+    return &vec->items[vec->count++];                                           \
+}                                                                               \
+                                                                                \
+static inline bool                                                              \
+Name##_Pop(Name *vec, Type *item)                                               \
+{                                                                               \
+    if (vec->count == 0) {                                                      \
+        return false;                                                           \
+    }                                                                           \
+                                                                                \
+    vec->count--;                                                               \
+                                                                                \
+    if (item != NULL) {                                                         \
+        *item = vec->items[vec->count];                                         \
+    }                                                                           \
+                                                                                \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline Type *                                                            \
+Name##_Get(const Name *vec, u64 index)                                          \
+{                                                                               \
+    return index < vec->count ? &vec->items[index] : NULL;                      \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_SwapRemove(Name *vec, u64 index)                                         \
+{                                                                               \
+    vec->items[index] = vec->items[--vec->count];                               \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Clear(Name *vec)                                                         \
+{                                                                               \
+    vec->count = 0;                                                             \
+}                                                                               \
+                                                                                \
+static inline void                                                              \
+Name##_Sort(Name *vec, VecCompare compare)                                      \
+{                                                                               \
+    if (vec->count > 1) {                                                       \
+        qsort(vec->items, vec->count, sizeof(Type), compare);                   \
+    }                                                                           \
+}
+
+#endif // VEC_TEMPLATE_H
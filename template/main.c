@@ -2,10 +2,12 @@
 // SPDX-License-Identifier: MIT
 
 void
-Part_One(Slice input)
+Part_One(const Slice input)
 {
+    SliceIterator lines = Slice_Iterate(input);
+
     while (1) {
-        Slice line = Slice_ReadLine(&input);
+        Slice line = SliceIterator_NextLine(&lines);
 
         if (line.data == NULL) {
             break;
@@ -14,10 +16,12 @@ Part_One(Slice input)
 }
 
 void
-Part_Two(Slice input)
+Part_Two(const Slice input)
 {
+    SliceIterator lines = Slice_Iterate(input);
+
     while (1) {
-        Slice line = Slice_ReadLine(&input);
+        Slice line = SliceIterator_NextLine(&lines);
 
         if (line.data == NULL) {
             break;
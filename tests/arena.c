@@ -0,0 +1,145 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Allocations of mixed sizes and alignments, some larger than a block, must
+// come back aligned and disjoint. Allocations made after Arena_Restore or
+// Arena_Reset must reuse the same blocks, and allocations made before a mark
+// must survive its restore.
+
+#define BLOCK_SIZE 256
+#define ALLOCATIONS 400
+
+typedef struct Allocation {
+    u8 *data;
+    u64 size;
+} Allocation;
+
+static Allocation Allocations[ALLOCATIONS];
+
+static u64
+Test_Size(u64 i)
+{
+    // Every 37th allocation is larger than a block and gets one of its own.
+    return i % 37 == 0 ? BLOCK_SIZE * 3 + i : 1 + (i * 13) % 90;
+}
+
+static u64
+Test_Alignment(u64 i)
+{
+    return (u64) 1 << (i % 7);
+}
+
+static void
+Test_Fill(u64 first, u64 last, Arena *arena)
+{
+    for (u64 i = first; i < last; ++i) {
+        u64 size = Test_Size(i);
+        u64 alignment = Test_Alignment(i);
+        u8 *data = Arena_Alloc(arena, size, alignment);
+
+        if ((uintptr_t) data % alignment != 0) {
+            Quit(1, "%s: allocation %lu is not aligned to %lu.", __FILE__, i, alignment);
+        }
+
+        memset(data, (int) (i & 0xFF), size);
+
+        Allocations[i] = (Allocation) {data, size};
+    }
+}
+
+static void
+Test_Verify(u64 first, u64 last)
+{
+    for (u64 i = first; i < last; ++i) {
+        for (u64 j = 0; j < Allocations[i].size; ++j) {
+            if (Allocations[i].data[j] != (u8) (i & 0xFF)) {
+                Quit(1, "%s: allocation %lu was overwritten at byte %lu.", __FILE__, i, j);
+            }
+        }
+    }
+}
+
+static void
+Test_Restore(void)
+{
+    Arena *arena = NULL;
+
+    Arena_Create(&arena, BLOCK_SIZE);
+
+    Test_Fill(0, ALLOCATIONS / 2, arena);
+
+    ArenaMark mark = Arena_Mark(arena);
+
+    Test_Fill(ALLOCATIONS / 2, ALLOCATIONS, arena);
+    Test_Verify(0, ALLOCATIONS);
+
+    u8 *first[ALLOCATIONS];
+
+    for (u64 i = 0; i < ALLOCATIONS; ++i) {
+        first[i] = Allocations[i].data;
+    }
+
+    Arena_Restore(arena, mark);
+
+    Test_Fill(ALLOCATIONS / 2, ALLOCATIONS, arena);
+    Test_Verify(0, ALLOCATIONS);
+
+    for (u64 i = ALLOCATIONS / 2; i < ALLOCATIONS; ++i) {
+        if (Allocations[i].data != first[i]) {
+            Quit(1, "%s: allocation %lu did not reuse its block after restore.", __FILE__, i);
+        }
+    }
+
+    Arena_Reset(arena);
+
+    Test_Fill(0, ALLOCATIONS, arena);
+    Test_Verify(0, ALLOCATIONS);
+
+    for (u64 i = 0; i < ALLOCATIONS; ++i) {
+        if (Allocations[i].data != first[i]) {
+            Quit(1, "%s: allocation %lu did not reuse its block after reset.", __FILE__, i);
+        }
+    }
+
+    Arena_Destroy(&arena);
+
+    if (arena != NULL) {
+        Quit(1, "%s: destroy did not clear the arena.", __FILE__);
+    }
+}
+
+static void
+Test_Push(void)
+{
+    Arena *arena = NULL;
+
+    Arena_Create(&arena, BLOCK_SIZE);
+
+    u8 *byte = ARENA_PUSH(arena, u8);
+    u64 *value = ARENA_PUSH(arena, u64);
+    max_align_t *block = ARENA_PUSH_ARRAY(arena, max_align_t, 100);
+
+    if ((uintptr_t) value % _Alignof(u64) != 0 || (uintptr_t) block % _Alignof(max_align_t) != 0) {
+        Quit(1, "%s: pushed values are not aligned.", __FILE__);
+    }
+
+    *byte = 1;
+    *value = 2;
+
+    memset(block, 3, sizeof(max_align_t) * 100);
+
+    if (*byte != 1 || *value != 2) {
+        Quit(1, "%s: pushed values overlap.", __FILE__);
+    }
+
+    Arena_Destroy(&arena);
+}
+
+int
+main(void)
+{
+    Test_Restore();
+    Test_Push();
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Reads generated line inputs through AsyncReader and checks that the
+// callback gets every byte in order, as whole-line '\0' terminated windows.
+// Small chunks make lines span chunk boundaries, a pipe takes the
+// synchronous fallback with short reads, and a partly consumed stdin must
+// be read from its current position.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define INPUT_MAX (64 * 1024)
+
+typedef struct TestState {
+    u64 position;
+    u64 stop_after;
+    u64 chunks;
+} TestState;
+
+static char Input[INPUT_MAX];
+static u64 InputSize = 0;
+static u64 Random = 88172645463325252ULL;
+
+static u64
+Test_Random(u64 limit)
+{
+    Random ^= Random << 13;
+    Random ^= Random >> 7;
+    Random ^= Random << 17;
+
+    return Random % limit;
+}
+
+static void
+Test_Generate(u64 size, u64 line_max, bool trailing_newline)
+{
+    InputSize = 0;
+
+    while (InputSize < size) {
+        u64 length = Test_Random(line_max + 1);
+
+        for (u64 i = 0; i < length && InputSize < size; ++i) {
+            Input[InputSize++] = (char) ('a' + Test_Random(26));
+        }
+
+        if (InputSize < size) {
+            Input[InputSize++] = '\n';
+        }
+    }
+
+    if (InputSize > 0) {
+        Input[InputSize - 1] = trailing_newline ? '\n' : 'z';
+    }
+}
+
+static int
+Test_OpenFile(char *path)
+{
+    int fd = mkstemp(path);
+
+    if (fd < 0 || write(fd, Input, InputSize) != (ssize_t) InputSize || lseek(fd, 0, SEEK_SET) != 0) {
+        Quit(1, "%s: can't write temporary file.", __FILE__);
+    }
+
+    return fd;
+}
+
+// Checks each chunk against Input, starting where the previous one ended.
+static bool
+Test_Callback(Slice chunk, void *context)
+{
+    TestState *state = context;
+
+    if (chunk.size == 0 || chunk.data[chunk.size] != '\0') {
+        Quit(1, "%s: malformed chunk at %lu.", __FILE__, state->position);
+    }
+
+    if (state->position + chunk.size > InputSize || memcmp(chunk.data, Input + state->position, chunk.size) != 0) {
+        Quit(1, "%s: chunk at %lu differs from the input.", __FILE__, state->position);
+    }
+
+    state->position += chunk.size;
+    state->chunks++;
+
+    if (chunk.data[chunk.size - 1] != '\n' && state->position != InputSize) {
+        Quit(1, "%s: chunk ending at %lu splits a line.", __FILE__, state->position);
+    }
+
+    return state->chunks != state->stop_after;
+}
+
+static void
+Test_Expect(TestState state, u64 total, u64 start, const char *name)
+{
+    if (state.position != InputSize || total != InputSize - start) {
+        Quit(1, "%s: %s read %lu bytes up to %lu of %lu.", __FILE__, name, total, state.position, InputSize);
+    }
+}
+
+static void
+Test_File(void)
+{
+    const u64 sizes[] = {0, 1, 63, 64, 65, 1000, 4097, INPUT_MAX - 3};
+    const AsyncReaderConfig configs[] = {{64, 1}, {64, 4}, {1000, 2}, {0, 0}};
+
+    for (u64 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        for (u64 c = 0; c < sizeof(configs) / sizeof(configs[0]); ++c) {
+            for (int trailing = 0; trailing < 2; ++trailing) {
+                char path[] = "/tmp/lib_test_async_reader_XXXXXX";
+
+                // Lines up to 300 bytes span several 64 byte chunks.
+                Test_Generate(sizes[s], 300, trailing);
+
+                int fd = Test_OpenFile(path);
+
+                close(fd);
+
+                TestState state = {0, 0, 0};
+                u64 total = AsyncReader_ReadFile(path, configs[c], Test_Callback, &state);
+
+                Test_Expect(state, total, 0, "file");
+
+                unlink(path);
+            }
+        }
+    }
+}
+
+// Stopping early must not deliver anything past the stop.
+static void
+Test_Stop(void)
+{
+    char path[] = "/tmp/lib_test_async_reader_XXXXXX";
+
+    Test_Generate(INPUT_MAX, 100, true);
+
+    int fd = Test_OpenFile(path);
+
+    close(fd);
+
+    TestState state = {0, 3, 0};
+
+    AsyncReader_ReadFile(path, (AsyncReaderConfig) {512, 4}, Test_Callback, &state);
+
+    if (state.chunks != 3) {
+        Quit(1, "%s: callback ran %lu times after asking to stop at 3.", __FILE__, state.chunks);
+    }
+
+    unlink(path);
+}
+
+// Consumes the first bytes of a file with a plain read, then hands it over
+// as stdin: only the rest may be delivered, and the position must end up
+// past everything read.
+static void
+Test_StdInOffset(void)
+{
+    char path[] = "/tmp/lib_test_async_reader_XXXXXX";
+
+    Test_Generate(INPUT_MAX, 120, true);
+
+    int fd = Test_OpenFile(path);
+
+    const char *newline = memchr(Input + 1000, '\n', InputSize - 1000);
+    u64 start = (u64) (newline - Input) + 1;
+    char skipped[INPUT_MAX];
+
+    if (read(fd, skipped, start) != (ssize_t) start || dup2(fd, STDIN_FILENO) < 0) {
+        Quit(1, "%s: can't set up stdin.", __FILE__);
+    }
+
+    close(fd);
+
+    TestState state = {start, 0, 0};
+    u64 total = AsyncReader_ReadStdIn((AsyncReaderConfig) {256, 4}, Test_Callback, &state);
+
+    Test_Expect(state, total, start, "partly consumed stdin");
+
+    if (lseek(STDIN_FILENO, 0, SEEK_CUR) != (off_t) InputSize) {
+        Quit(1, "%s: stdin left at %ld, expected %lu.", __FILE__, (long) lseek(STDIN_FILENO, 0, SEEK_CUR), InputSize);
+    }
+
+    unlink(path);
+}
+
+static void *
+Test_PipeWriter(void *argument)
+{
+    int fd = *(int *) argument;
+    u64 written = 0;
+
+    while (written < InputSize) {
+        u64 size = 1 + Test_Random(97);
+
+        if (size > InputSize - written) {
+            size = InputSize - written;
+        }
+
+        if (write(fd, Input + written, size) != (ssize_t) size) {
+            Quit(1, "%s: can't write to pipe.", __FILE__);
+        }
+
+        written += size;
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+// A pipe can't be read at offsets, so this goes through the synchronous
+// path, and the small uneven writes produce short reads.
+static void
+Test_Pipe(void)
+{
+    int fds[2];
+    pthread_t writer;
+
+    Test_Generate(INPUT_MAX, 300, false);
+
+    if (pipe(fds) != 0 || dup2(fds[0], STDIN_FILENO) < 0) {
+        Quit(1, "%s: can't set up pipe.", __FILE__);
+    }
+
+    close(fds[0]);
+
+    if (pthread_create(&writer, NULL, Test_PipeWriter, &fds[1]) != 0) {
+        Quit(1, "%s: can't create writer thread.", __FILE__);
+    }
+
+    TestState state = {0, 0, 0};
+    u64 total = AsyncReader_ReadStdIn((AsyncReaderConfig) {64, 4}, Test_Callback, &state);
+
+    pthread_join(writer, NULL);
+
+    Test_Expect(state, total, 0, "pipe");
+}
+
+int
+main(void)
+{
+    Test_File();
+    Test_Stop();
+    Test_StdInOffset();
+    Test_Pipe();
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Integer keys inserted in scrambled order must come back in numeric order
+// with the typed comparators, and random inserts, upserts and erases must
+// agree with a presence array, which exercises the AVL rebalancing on both
+// paths and the reuse of pooled nodes.
+
+#define KEYS 5000
+#define RANDOM_KEYS 2000
+#define RANDOM_STEPS 200000
+
+static bool Present[RANDOM_KEYS];
+
+static void
+Test_U64(void)
+{
+    BinaryTree *tree = NULL;
+
+    BinaryTree_Create(&tree, (BinaryTreeConfig) {
+        .key_size = sizeof(u64),
+        .value_size = sizeof(u64),
+        .compare = BinaryTree_CompareU64,
+    });
+
+    for (u64 i = 0; i < KEYS; ++i) {
+        u64 key = (i * 7919) % KEYS * 257;
+        u64 value = key + 1;
+
+        if (!BinaryTree_Insert(tree, &key, &value)) {
+            Quit(1, "%s: key %lu inserted twice.", __FILE__, key);
+        }
+    }
+
+    BinaryTreeIterator iterator = BinaryTree_Iterate(tree);
+    BinaryTreeEntry entry;
+    u64 expected = 0;
+
+    while (BinaryTreeIterator_Next(&iterator, &entry)) {
+        u64 key;
+        u64 value;
+
+        memcpy(&key, entry.key, sizeof(key));
+        memcpy(&value, entry.value, sizeof(value));
+
+        if (key != expected * 257 || value != key + 1) {
+            Quit(1, "%s: got key %lu, expected %lu.", __FILE__, key, expected * 257);
+        }
+
+        expected++;
+    }
+
+    if (expected != KEYS || BinaryTree_Count(tree) != KEYS) {
+        Quit(1, "%s: iterated %lu keys, expected %d.", __FILE__, expected, KEYS);
+    }
+
+    BinaryTree_Destroy(&tree);
+}
+
+static void
+Test_I64(void)
+{
+    BinaryTree *tree = NULL;
+
+    BinaryTree_Create(&tree, (BinaryTreeConfig) {
+        .key_size = sizeof(i64),
+        .value_size = 0,
+        .compare = BinaryTree_CompareI64,
+    });
+
+    for (i64 i = 0; i < KEYS; ++i) {
+        i64 key = (i * 7919) % KEYS - KEYS / 2;
+
+        BinaryTree_Insert(tree, &key, NULL);
+    }
+
+    BinaryTreeIterator iterator = BinaryTree_Iterate(tree);
+    BinaryTreeEntry entry;
+    i64 expected = -KEYS / 2;
+
+    while (BinaryTreeIterator_Next(&iterator, &entry)) {
+        i64 key;
+
+        memcpy(&key, entry.key, sizeof(key));
+
+        if (key != expected) {
+            Quit(1, "%s: got key %ld, expected %ld.", __FILE__, key, expected);
+        }
+
+        expected++;
+    }
+
+    if (expected != KEYS - KEYS / 2) {
+        Quit(1, "%s: iteration stopped at %ld.", __FILE__, expected);
+    }
+
+    BinaryTree_Destroy(&tree);
+}
+
+static void
+Test_Check(const BinaryTree *tree, u64 count)
+{
+    if (BinaryTree_Count(tree) != count) {
+        Quit(1, "%s: count is %lu, expected %lu.", __FILE__, BinaryTree_Count(tree), count);
+    }
+
+    BinaryTreeIterator iterator = BinaryTree_Iterate(tree);
+    BinaryTreeEntry entry;
+    u64 index = 0;
+
+    while (BinaryTreeIterator_Next(&iterator, &entry)) {
+        u64 key;
+
+        memcpy(&key, entry.key, sizeof(key));
+
+        while (index < RANDOM_KEYS && !Present[index]) {
+            index++;
+        }
+
+        if (key != index || *(u64 *) entry.value != key * 3) {
+            Quit(1, "%s: iteration returned key %lu, expected %lu.", __FILE__, key, index);
+        }
+
+        index++;
+    }
+
+    while (index < RANDOM_KEYS && !Present[index]) {
+        index++;
+    }
+
+    if (index != RANDOM_KEYS) {
+        Quit(1, "%s: iteration stopped before key %lu.", __FILE__, index);
+    }
+}
+
+static void
+Test_Random(void)
+{
+    BinaryTree *tree = NULL;
+    u64 state = 2463534242ULL;
+    u64 count = 0;
+
+    BinaryTree_Create(&tree, (BinaryTreeConfig) {
+        .key_size = sizeof(u64),
+        .value_size = sizeof(u64),
+        .compare = BinaryTree_CompareU64,
+    });
+
+    for (u64 step = 0; step < RANDOM_STEPS; ++step) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        u64 key = state % RANDOM_KEYS;
+        u64 operation = (state >> 32) % 4;
+        u64 *found = BinaryTree_Find(tree, &key);
+
+        if ((found != NULL) != Present[key] || (found != NULL && *found != key * 3)) {
+            Quit(1, "%s: find of key %lu disagrees at step %lu.", __FILE__, key, step);
+        }
+
+        if (operation == 0) {
+            u64 value = key * 3;
+
+            if (BinaryTree_Insert(tree, &key, &value) == Present[key]) {
+                Quit(1, "%s: insert of key %lu disagrees at step %lu.", __FILE__, key, step);
+            }
+        } else if (operation == 1) {
+            bool inserted;
+            u64 *value = BinaryTree_Upsert(tree, &key, &inserted);
+
+            if (inserted == Present[key] || (!inserted && *value != key * 3)) {
+                Quit(1, "%s: upsert of key %lu disagrees at step %lu.", __FILE__, key, step);
+            }
+
+            *value = key * 3;
+        } else {
+            if (BinaryTree_Erase(tree, &key) != Present[key]) {
+                Quit(1, "%s: erase of key %lu disagrees at step %lu.", __FILE__, key, step);
+            }
+
+            count -= Present[key];
+            Present[key] = false;
+
+            if (BinaryTree_Count(tree) != count) {
+                Quit(1, "%s: count is %lu after erasing key %lu, expected %lu.", __FILE__, BinaryTree_Count(tree), key, count);
+            }
+
+            continue;
+        }
+
+        count += !Present[key];
+        Present[key] = true;
+    }
+
+    Test_Check(tree, count);
+
+    // Drain the tree completely, then refill it from the freed nodes.
+    for (u64 key = 0; key < RANDOM_KEYS; ++key) {
+        if (BinaryTree_Erase(tree, &key) != Present[key]) {
+            Quit(1, "%s: erase of key %lu disagrees while draining.", __FILE__, key);
+        }
+
+        count -= Present[key];
+        Present[key] = false;
+
+        if (BinaryTree_Count(tree) != count) {
+            Quit(1, "%s: count is %lu while draining, expected %lu.", __FILE__, BinaryTree_Count(tree), count);
+        }
+    }
+
+    for (u64 key = RANDOM_KEYS; key > 0; --key) {
+        u64 value = (key - 1) * 3;
+        u64 inserted = key - 1;
+
+        BinaryTree_Insert(tree, &inserted, &value);
+
+        Present[key - 1] = true;
+    }
+
+    Test_Check(tree, RANDOM_KEYS);
+
+    BinaryTree_Destroy(&tree);
+}
+
+int
+main(void)
+{
+    Test_U64();
+    Test_I64();
+    Test_Random();
+
+    return 0;
+}
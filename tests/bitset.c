@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Applies ranges of every alignment and length, long enough to take the
+// whole-word path, to a Bitset and to a plain bool array, and compares them.
+
+#define BITS 1000
+#define STEPS 20000
+
+static bool Expected[BITS];
+
+static void
+Test_Compare(const Bitset *set, u64 step)
+{
+    u64 count = 0;
+
+    for (u64 i = 0; i < BITS; ++i) {
+        if (Bitset_Test(set, i) != Expected[i]) {
+            Quit(1, "%s: bit %lu differs after step %lu.", __FILE__, i, step);
+        }
+
+        count += Expected[i];
+    }
+
+    if (Bitset_Count(set) != count) {
+        Quit(1, "%s: count is %lu after step %lu, expected %lu.", __FILE__, Bitset_Count(set), step, count);
+    }
+}
+
+int
+main(void)
+{
+    Bitset *set = NULL;
+    u64 state = 12345;
+
+    Bitset_Create(&set, BITS);
+
+    for (u64 step = 0; step < STEPS; ++step) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        u64 first = (state >> 33) % BITS;
+        u64 last = first + (state >> 13) % (BITS - first + 1);
+        u64 operation = (state >> 50) % 3;
+
+        if (operation == 0) {
+            Bitset_SetRange(set, first, last);
+        } else if (operation == 1) {
+            Bitset_ClearRange(set, first, last);
+        } else {
+            Bitset_FlipRange(set, first, last);
+        }
+
+        for (u64 i = first; i < last; ++i) {
+            Expected[i] = operation == 0 ? true : operation == 1 ? false : !Expected[i];
+        }
+
+        Test_Compare(set, step);
+    }
+
+    Bitset_Destroy(&set);
+
+    return 0;
+}
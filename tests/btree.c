@@ -0,0 +1,151 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Checks BTree against a plain presence array: inserts in scrambled order
+// with enough keys to split inner nodes, upserts, erases every third key and
+// then compares lookups, full iteration and ranges. Keys are spread over the
+// whole u64 range, so both halves of the biased key order get exercised.
+
+#define KEYS 20000
+#define STRIDE 0x0000D1B54A32D193ULL
+
+static bool Present[KEYS];
+
+static inline u64
+Test_Key(u64 index)
+{
+    // Index order is key order: STRIDE * (KEYS - 1) fits in a u64, and the
+    // last key is UINT64_MAX.
+    return (index == KEYS - 1) ? UINT64_MAX : index * STRIDE;
+}
+
+static void
+Test_Check(const BTree *tree)
+{
+    u64 count = 0;
+
+    for (u64 i = 0; i < KEYS; ++i) {
+        u64 *value = BTree_Find(tree, Test_Key(i));
+
+        if (Present[i] != (value != NULL)) {
+            Quit(1, "%s: key %lu is %s.", __FILE__, Test_Key(i), Present[i] ? "missing" : "unexpected");
+        }
+
+        if (value != NULL && *value != i) {
+            Quit(1, "%s: key %lu holds %lu, expected %lu.", __FILE__, Test_Key(i), *value, i);
+        }
+
+        count += Present[i];
+    }
+
+    if (BTree_Count(tree) != count) {
+        Quit(1, "%s: count is %lu, expected %lu.", __FILE__, BTree_Count(tree), count);
+    }
+
+    BTreeIterator iterator = BTree_Iterate(tree);
+    u64 index = 0;
+    u64 key;
+    void *value;
+
+    while (BTreeIterator_Next(&iterator, &key, &value)) {
+        while (index < KEYS && !Present[index]) {
+            index++;
+        }
+
+        if (index == KEYS || key != Test_Key(index)) {
+            Quit(1, "%s: iteration returned key %lu out of order.", __FILE__, key);
+        }
+
+        index++;
+    }
+
+    while (index < KEYS && !Present[index]) {
+        index++;
+    }
+
+    if (index != KEYS) {
+        Quit(1, "%s: iteration stopped before key %lu.", __FILE__, Test_Key(index));
+    }
+}
+
+static void
+Test_Range(const BTree *tree, u64 first, u64 last)
+{
+    BTreeIterator iterator = BTree_Range(tree, Test_Key(first), Test_Key(last));
+    u64 expected = 0;
+    u64 seen = 0;
+    u64 key;
+    void *value;
+
+    for (u64 i = first; i <= last; ++i) {
+        expected += Present[i];
+    }
+
+    while (BTreeIterator_Next(&iterator, &key, &value)) {
+        if (key < Test_Key(first) || key > Test_Key(last)) {
+            Quit(1, "%s: range [%lu, %lu] returned key %lu.", __FILE__, first, last, key);
+        }
+
+        seen++;
+    }
+
+    if (seen != expected) {
+        Quit(1, "%s: range [%lu, %lu] returned %lu keys, expected %lu.", __FILE__, first, last, seen, expected);
+    }
+}
+
+int
+main(void)
+{
+    BTree *tree = NULL;
+
+    BTree_Create(&tree, (BTreeConfig) {.value_size = sizeof(u64)});
+
+    for (u64 i = 0; i < KEYS; ++i) {
+        u64 index = (i * 7919) % KEYS;
+
+        if (!BTree_Insert(tree, Test_Key(index), &index)) {
+            Quit(1, "%s: fresh key %lu not inserted.", __FILE__, Test_Key(index));
+        }
+
+        Present[index] = true;
+    }
+
+    Test_Check(tree);
+
+    for (u64 i = 0; i < KEYS; ++i) {
+        bool inserted = true;
+        u64 *value = BTree_Upsert(tree, Test_Key(i), &inserted);
+
+        if (inserted || *value != i) {
+            Quit(1, "%s: upsert of existing key %lu changed it.", __FILE__, Test_Key(i));
+        }
+
+        if (BTree_Insert(tree, Test_Key(i), &i)) {
+            Quit(1, "%s: key %lu inserted twice.", __FILE__, Test_Key(i));
+        }
+    }
+
+    for (u64 i = 0; i < KEYS; i += 3) {
+        if (!BTree_Erase(tree, Test_Key(i))) {
+            Quit(1, "%s: key %lu not erased.", __FILE__, Test_Key(i));
+        }
+
+        Present[i] = false;
+    }
+
+    if (BTree_Erase(tree, Test_Key(0))) {
+        Quit(1, "%s: key %lu erased twice.", __FILE__, Test_Key(0));
+    }
+
+    Test_Check(tree);
+
+    Test_Range(tree, 0, KEYS - 1);
+    Test_Range(tree, 100, 5000);
+    Test_Range(tree, KEYS / 2, KEYS / 2);
+    Test_Range(tree, KEYS - 40, KEYS - 1);
+
+    BTree_Destroy(&tree);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Every thread inserts the same keys in its own order into a set that starts
+// at the minimum capacity, so inserts race with each other and with several
+// resizes. Each key must be reported as new exactly once.
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define THREADS 8
+#define KEYS 200000
+#define ROUNDS 4
+
+static ConcurrentSet *Set;
+static _Atomic u32 Hits[KEYS];
+
+static u64
+Test_Key(u64 index)
+{
+    // Covers both values the set reserves for its slots.
+    return (index == KEYS - 1) ? UINT64_MAX : index;
+}
+
+static void *
+Test_Insert(void *argument)
+{
+    u64 id = (u64) (uintptr_t) argument;
+
+    for (u64 i = 0; i < KEYS; ++i) {
+        u64 index = (i * 7919 + id * (KEYS / THREADS)) % KEYS;
+
+        if (ConcurrentSet_InsertIfAbsent(Set, Test_Key(index))) {
+            atomic_fetch_add(&Hits[index], 1);
+        }
+
+        if (!ConcurrentSet_Contains(Set, Test_Key(index))) {
+            Quit(1, "%s: key %lu missing right after its insert.", __FILE__, Test_Key(index));
+        }
+    }
+
+    return NULL;
+}
+
+int
+main(void)
+{
+    for (u32 round = 0; round < ROUNDS; ++round) {
+        ConcurrentSet_Create(&Set, 0);
+
+        for (u64 i = 0; i < KEYS; ++i) {
+            atomic_init(&Hits[i], 0);
+        }
+
+        pthread_t threads[THREADS];
+
+        for (u64 i = 0; i < THREADS; ++i) {
+            if (pthread_create(&threads[i], NULL, Test_Insert, (void *) (uintptr_t) i) != 0) {
+                Quit(1, "%s: can't create thread.", __FILE__);
+            }
+        }
+
+        for (u64 i = 0; i < THREADS; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+
+        for (u64 i = 0; i < KEYS; ++i) {
+            if (atomic_load(&Hits[i]) != 1) {
+                Quit(1, "%s: key %lu reported as new %u times.", __FILE__, Test_Key(i), atomic_load(&Hits[i]));
+            }
+
+            if (!ConcurrentSet_Contains(Set, Test_Key(i))) {
+                Quit(1, "%s: key %lu missing.", __FILE__, Test_Key(i));
+            }
+        }
+
+        if (ConcurrentSet_Count(Set) != KEYS) {
+            Quit(1, "%s: count is %lu, expected %d.", __FILE__, ConcurrentSet_Count(Set), KEYS);
+        }
+
+        if (ConcurrentSet_Contains(Set, KEYS)) {
+            Quit(1, "%s: key %d was never inserted.", __FILE__, KEYS);
+        }
+
+        ConcurrentSet_Destroy(&Set);
+    }
+
+    return 0;
+}
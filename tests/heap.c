@@ -0,0 +1,141 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Random pushes, priority changes in both directions and pops on an indexed
+// heap must agree with a brute-force minimum over a cost array, and a heap
+// created with no capacity must still be usable as an empty queue.
+
+#define COST_LESS(left, right) ((left) < (right))
+
+DEFINE_HEAP(CostQueue, u64, COST_LESS)
+
+#define HANDLES 500
+#define RANDOM_STEPS 200000
+
+static u64 Cost[HANDLES];
+static bool Queued[HANDLES];
+
+static u64
+Test_Minimum(u32 *count)
+{
+    u64 minimum = UINT64_MAX;
+
+    *count = 0;
+
+    for (u32 i = 0; i < HANDLES; ++i) {
+        if (Queued[i]) {
+            (*count)++;
+
+            if (Cost[i] < minimum) {
+                minimum = Cost[i];
+            }
+        }
+    }
+
+    return minimum;
+}
+
+static void
+Test_Pop(CostQueue *queue, u64 step)
+{
+    u32 count;
+    u64 minimum = Test_Minimum(&count);
+    u32 handle = HEAP_ABSENT;
+    u64 cost = 0;
+
+    if (CostQueue_Pop(queue, &handle, &cost) != (count > 0)) {
+        Quit(1, "%s: pop disagrees with %u queued handles at step %lu.", __FILE__, count, step);
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    if (cost != minimum || !Queued[handle] || Cost[handle] != cost) {
+        Quit(1, "%s: popped cost %lu of handle %u, expected %lu at step %lu.", __FILE__, cost, handle, minimum, step);
+    }
+
+    Queued[handle] = false;
+}
+
+static void
+Test_Random(void)
+{
+    CostQueue *queue = NULL;
+    u64 state = 88172645463325252ULL;
+
+    CostQueue_Create(&queue, HANDLES);
+
+    for (u64 step = 0; step < RANDOM_STEPS; ++step) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        u32 handle = (u32) (state % HANDLES);
+        u64 operation = (state >> 32) % 4;
+        u64 cost = (state >> 40) % 1000;
+
+        if (operation == 0 || operation == 1) {
+            CostQueue_Push(queue, handle, cost);
+
+            Cost[handle] = cost;
+            Queued[handle] = true;
+        } else if (operation == 2) {
+            if (Queued[handle]) {
+                CostQueue_Update(queue, handle, cost);
+
+                Cost[handle] = cost;
+            }
+        } else {
+            Test_Pop(queue, step);
+        }
+
+        u32 count;
+        u64 minimum = Test_Minimum(&count);
+        const u64 *peek = CostQueue_Peek(queue, NULL);
+        const u64 *get = CostQueue_Get(queue, handle);
+
+        if (CostQueue_Count(queue) != count || (peek == NULL) != (count == 0) || (peek != NULL && *peek != minimum)) {
+            Quit(1, "%s: heap disagrees with %u queued handles at step %lu.", __FILE__, count, step);
+        }
+
+        if (CostQueue_Contains(queue, handle) != Queued[handle] || (get == NULL) == Queued[handle] || (get != NULL && *get != Cost[handle])) {
+            Quit(1, "%s: handle %u disagrees at step %lu.", __FILE__, handle, step);
+        }
+    }
+
+    while (CostQueue_Count(queue) > 0) {
+        Test_Pop(queue, RANDOM_STEPS);
+    }
+
+    Test_Pop(queue, RANDOM_STEPS);
+
+    CostQueue_Destroy(&queue);
+
+    if (queue != NULL) {
+        Quit(1, "%s: destroy did not clear the heap.", __FILE__);
+    }
+}
+
+static void
+Test_Empty(void)
+{
+    CostQueue *queue = NULL;
+
+    CostQueue_Create(&queue, 0);
+
+    if (CostQueue_Count(queue) != 0 || CostQueue_Peek(queue, NULL) != NULL || CostQueue_Pop(queue, NULL, NULL)) {
+        Quit(1, "%s: a heap without capacity is not empty.", __FILE__);
+    }
+
+    CostQueue_Destroy(&queue);
+}
+
+int
+main(void)
+{
+    Test_Random();
+    Test_Empty();
+
+    return 0;
+}
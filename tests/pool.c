@@ -0,0 +1,206 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Alternating between thread cached pools must reuse the objects freed to
+// each of them instead of growing new slabs, including when a thread uses
+// more pools than it keeps caches for and when one of them is destroyed.
+// Several threads sharing those pools, and freeing objects another thread
+// allocated, must never be handed the same object twice.
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define ROUNDS 100000
+#define POOLS 12
+#define LIVE 3
+#define THREADS 4
+#define THREAD_ROUNDS 20000
+
+static Pool *Shared[POOLS];
+static _Atomic(u64 *) Exchange[POOLS];
+
+static void
+Test_Bounded(Pool *pool, const char *name)
+{
+    // Every pool holds at most LIVE objects at a time plus whatever the
+    // thread caches, which fits in one slab.
+    if (Pool_SlabCount(pool) > 1) {
+        Quit(1, "%s: %s grew to %lu slabs.", __FILE__, name, Pool_SlabCount(pool));
+    }
+}
+
+static void
+Test_Alternate(void)
+{
+    Pool *first = NULL;
+    Pool *second = NULL;
+
+    Pool_Create(&first, (PoolConfig) {.object_size = 24, .thread_cache = true});
+    Pool_Create(&second, (PoolConfig) {.object_size = 40, .thread_cache = true});
+
+    for (u64 i = 0; i < ROUNDS; ++i) {
+        void *a = Pool_Alloc(first);
+        void *b = Pool_Alloc(second);
+
+        Pool_Free(first, a);
+        Pool_Free(second, b);
+    }
+
+    Test_Bounded(first, "first pool");
+    Test_Bounded(second, "second pool");
+
+    Pool_Destroy(&second);
+    Pool_Destroy(&first);
+}
+
+static void
+Test_Cycle(Pool **pools, u64 count)
+{
+    for (u64 round = 0; round < ROUNDS / 10; ++round) {
+        for (u64 p = 0; p < count; ++p) {
+            if (pools[p] == NULL) {
+                continue;
+            }
+
+            void *objects[LIVE];
+
+            for (u64 i = 0; i < LIVE; ++i) {
+                objects[i] = Pool_Alloc(pools[p]);
+
+                memset(objects[i], (int) p, 16);
+            }
+
+            for (u64 i = 0; i < LIVE; ++i) {
+                Pool_Free(pools[p], objects[i]);
+            }
+        }
+    }
+
+    for (u64 p = 0; p < count; ++p) {
+        if (pools[p] != NULL) {
+            Test_Bounded(pools[p], "cycled pool");
+        }
+    }
+}
+
+static void
+Test_ManyPools(void)
+{
+    Pool *pools[POOLS];
+
+    for (u64 p = 0; p < POOLS; ++p) {
+        pools[p] = NULL;
+
+        Pool_Create(&pools[p], (PoolConfig) {.object_size = 16 + p * 8, .thread_cache = true});
+    }
+
+    Test_Cycle(pools, POOLS);
+
+    // Destroyed pools give up their cache slots to the remaining ones.
+    Pool_Destroy(&pools[0]);
+    Pool_Destroy(&pools[POOLS / 2]);
+
+    Test_Cycle(pools, POOLS);
+
+    for (u64 p = 0; p < POOLS; ++p) {
+        Pool_Destroy(&pools[p]);
+    }
+}
+
+static void
+Test_Tag(u64 *object, u64 tag)
+{
+    object[0] = tag;
+    object[1] = ~tag;
+}
+
+static void
+Test_Untag(u64 *object, u64 tag)
+{
+    // A tag other than the one written means another thread was handed the
+    // same object in between.
+    if (object[0] != tag || object[1] != ~tag) {
+        Quit(1, "%s: object %p was handed out twice.", __FILE__, (void *) object);
+    }
+}
+
+static void *
+Test_Share(void *argument)
+{
+    u64 id = (u64) (uintptr_t) argument;
+
+    for (u64 round = 0; round < THREAD_ROUNDS; ++round) {
+        // Walk the pools in a different order on every thread, more of them
+        // than a thread keeps caches for.
+        for (u64 i = 0; i < POOLS; ++i) {
+            u64 p = (i + id * 5) % POOLS;
+            u64 *objects[LIVE];
+
+            for (u64 j = 0; j < LIVE; ++j) {
+                objects[j] = Pool_Alloc(Shared[p]);
+
+                Test_Tag(objects[j], (id << 48) | (round << 8) | j);
+            }
+
+            // Hand one object to whichever thread visits this pool next and
+            // free the one left there, usually allocated by another thread.
+            u64 *other = atomic_exchange(&Exchange[p], objects[0]);
+
+            if (other != NULL) {
+                Test_Untag(other, other[0]);
+                Pool_Free(Shared[p], other);
+            }
+
+            for (u64 j = 1; j < LIVE; ++j) {
+                Test_Untag(objects[j], (id << 48) | (round << 8) | j);
+                Pool_Free(Shared[p], objects[j]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void
+Test_Threads(void)
+{
+    for (u64 p = 0; p < POOLS; ++p) {
+        Shared[p] = NULL;
+
+        Pool_Create(&Shared[p], (PoolConfig) {.object_size = 16 + p * 8, .slab_objects = 64, .thread_cache = true});
+        atomic_init(&Exchange[p], NULL);
+    }
+
+    pthread_t threads[THREADS];
+
+    for (u64 i = 0; i < THREADS; ++i) {
+        if (pthread_create(&threads[i], NULL, Test_Share, (void *) (uintptr_t) i) != 0) {
+            Quit(1, "%s: can't create thread.", __FILE__);
+        }
+    }
+
+    for (u64 i = 0; i < THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (u64 p = 0; p < POOLS; ++p) {
+        u64 *other = atomic_load(&Exchange[p]);
+
+        if (other != NULL) {
+            Test_Untag(other, other[0]);
+            Pool_Free(Shared[p], other);
+        }
+
+        Pool_Destroy(&Shared[p]);
+    }
+}
+
+int
+main(void)
+{
+    Test_Alternate();
+    Test_ManyPools();
+    Test_Threads();
+
+    return 0;
+}
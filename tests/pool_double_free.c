@@ -0,0 +1,22 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Freeing an object twice must stop the program in debug builds, so this
+// test is registered as expected to fail.
+
+int
+main(void)
+{
+    Pool *pool = NULL;
+
+    Pool_Create(&pool, (PoolConfig) {.object_size = 32});
+
+    void *object = Pool_Alloc(pool);
+
+    Pool_Free(pool, object);
+    Pool_Free(pool, object);
+
+    Pool_Destroy(&pool);
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Feeds generated line-based inputs through the chunked input APIs, the line
+// splitter and StdIn_ReadLine and checks them against the original bytes.
+// Inputs mix empty lines, lines longer than a chunk and sizes that aren't a
+// multiple of any block size, with and without a trailing newline.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define INPUT_MAX (256 * 1024)
+
+static char Input[INPUT_MAX];
+static u64 InputSize = 0;
+static u64 Random = 88172645463325252ULL;
+
+static u64
+Test_Random(u64 limit)
+{
+    Random ^= Random << 13;
+    Random ^= Random >> 7;
+    Random ^= Random << 17;
+
+    return Random % limit;
+}
+
+// Lines are up to line_max bytes of printable characters.
+static void
+Test_Generate(u64 size, u64 line_max, bool trailing_newline)
+{
+    InputSize = 0;
+
+    while (InputSize < size) {
+        u64 length = Test_Random(line_max + 1);
+
+        for (u64 i = 0; i < length && InputSize < size; ++i) {
+            Input[InputSize++] = (char) ('a' + Test_Random(26));
+        }
+
+        if (InputSize < size) {
+            Input[InputSize++] = '\n';
+        }
+    }
+
+    if (InputSize > 0) {
+        Input[InputSize - 1] = trailing_newline ? '\n' : 'z';
+    }
+}
+
+// Writes Input to a temporary file and returns its path.
+static const char *
+Test_WriteFile(void)
+{
+    static char path[] = "/tmp/lib_test_slice_XXXXXX";
+
+    memcpy(path + sizeof(path) - 7, "XXXXXX", 6);
+
+    int fd = mkstemp(path);
+
+    if (fd < 0 || write(fd, Input, InputSize) != (ssize_t) InputSize) {
+        Quit(1, "%s: can't write temporary file.", __FILE__);
+    }
+
+    close(fd);
+
+    return path;
+}
+
+static void *
+Test_PipeWriter(void *argument)
+{
+    int fd = *(int *) argument;
+    u64 written = 0;
+
+    // Small uneven writes make the reader see short reads.
+    while (written < InputSize) {
+        u64 size = 1 + Test_Random(97);
+
+        if (size > InputSize - written) {
+            size = InputSize - written;
+        }
+
+        if (write(fd, Input + written, size) != (ssize_t) size) {
+            Quit(1, "%s: can't write to pipe.", __FILE__);
+        }
+
+        written += size;
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+static void
+Test_ReaderDrain(SliceReader *reader, const char *name)
+{
+    u64 position = 0;
+
+    while (1) {
+        Slice chunk = SliceReader_Next(reader);
+
+        if (chunk.data == NULL) {
+            break;
+        }
+
+        if (chunk.size == 0 || chunk.data[chunk.size] != '\0') {
+            Quit(1, "%s: %s returned a malformed chunk at %lu.", __FILE__, name, position);
+        }
+
+        if (position + chunk.size > InputSize || memcmp(chunk.data, Input + position, chunk.size) != 0) {
+            Quit(1, "%s: %s chunk at %lu differs from the input.", __FILE__, name, position);
+        }
+
+        position += chunk.size;
+
+        // Only the final chunk may end in the middle of a line.
+        if (chunk.data[chunk.size - 1] != '\n' && position != InputSize) {
+            Quit(1, "%s: %s split a line at %lu.", __FILE__, name, position);
+        }
+    }
+
+    if (position != InputSize) {
+        Quit(1, "%s: %s stopped at %lu of %lu bytes.", __FILE__, name, position, InputSize);
+    }
+}
+
+static void
+Test_Reader(void)
+{
+    const u64 sizes[] = {0, 1, 15, 33, 1000, 4097, 100003};
+    const u64 chunks[] = {16, 61, 4096};
+
+    for (u64 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        for (u64 c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            for (int trailing = 0; trailing < 2; ++trailing) {
+                SliceReader *reader = NULL;
+
+                // Lines up to 200 bytes are longer than the smaller chunks,
+                // which makes the reader grow its buffers.
+                Test_Generate(sizes[s], 200, trailing);
+
+                const char *path = Test_WriteFile();
+
+                SliceReader_Open(&reader, path, chunks[c]);
+                Test_ReaderDrain(reader, "file reader");
+                SliceReader_Close(&reader);
+
+                unlink(path);
+
+                int fds[2];
+                pthread_t writer;
+
+                if (pipe(fds) != 0 || pthread_create(&writer, NULL, Test_PipeWriter, &fds[1]) != 0) {
+                    Quit(1, "%s: can't set up pipe.", __FILE__);
+                }
+
+                SliceReader_Attach(&reader, fds[0], chunks[c]);
+                Test_ReaderDrain(reader, "pipe reader");
+                SliceReader_Close(&reader);
+
+                pthread_join(writer, NULL);
+                close(fds[0]);
+            }
+        }
+    }
+}
+
+static void
+Test_SplitLinesCheck(void)
+{
+    SliceLines lines = Slice_SplitLines((Slice) {Input, InputSize});
+    u64 start = 0;
+    u64 index = 0;
+
+    while (start < InputSize) {
+        const char *newline = memchr(Input + start, '\n', InputSize - start);
+        u64 end = newline != NULL ? (u64) (newline - Input) : InputSize;
+        Slice line = SliceLines_Get(lines, index);
+
+        if (line.data != Input + start || line.size != end - start) {
+            Quit(1, "%s: line %lu of %lu bytes is wrong.", __FILE__, index, InputSize);
+        }
+
+        start = end + 1;
+        index++;
+    }
+
+    if (lines.count != index || SliceLines_Get(lines, index).data != NULL) {
+        Quit(1, "%s: %lu lines split from %lu bytes, expected %lu.", __FILE__, lines.count, InputSize, index);
+    }
+
+    SliceLines_Destroy(&lines);
+}
+
+static void
+Test_SplitLines(void)
+{
+    // Every size up to a few SIMD blocks, so each tail length is covered.
+    for (u64 size = 0; size <= 200; ++size) {
+        for (int trailing = 0; trailing < 2; ++trailing) {
+            Test_Generate(size, 40, trailing);
+            Test_SplitLinesCheck();
+        }
+    }
+
+    // Dense newlines push past the initial offset table.
+    Test_Generate(100003, 2, false);
+    Test_SplitLinesCheck();
+
+    Test_Generate(INPUT_MAX, 300, true);
+    Test_SplitLinesCheck();
+}
+
+// StdIn_ReadLine keeps its state for the whole process, so stdin is
+// redirected only once, to short lines followed by a last line longer than
+// its initial 64 KB buffer and without a trailing newline.
+static void
+Test_ReadLine(void)
+{
+    Test_Generate(INPUT_MAX / 2, 300, true);
+
+    while (InputSize < INPUT_MAX) {
+        Input[InputSize++] = (char) ('a' + Test_Random(26));
+    }
+
+    const char *path = Test_WriteFile();
+
+    if (freopen(path, "r", stdin) == NULL) {
+        Quit(1, "%s: can't redirect stdin.", __FILE__);
+    }
+
+    u64 start = 0;
+
+    while (1) {
+        Slice line = StdIn_ReadLine();
+
+        if (line.data == NULL) {
+            break;
+        }
+
+        const char *newline = memchr(Input + start, '\n', InputSize - start);
+        u64 end = newline != NULL ? (u64) (newline - Input) : InputSize;
+
+        if (line.size != end - start || memcmp(line.data, Input + start, line.size) != 0 || line.data[line.size] != '\0') {
+            Quit(1, "%s: line at %lu differs from the input.", __FILE__, start);
+        }
+
+        start = end + 1;
+    }
+
+    if (start != InputSize + 1) {
+        Quit(1, "%s: StdIn_ReadLine stopped at %lu of %lu bytes.", __FILE__, start, InputSize);
+    }
+
+    unlink(path);
+}
+
+static void
+Test_Unescape(void)
+{
+    static const struct {
+        const char *text;
+        u64 expected;
+    } cases[] = {
+        { "", 0 },
+        { "abc", 3 },
+        { "aaa\\\"aaa", 7 },
+        { "\\x27", 1 },
+        { "\\\\", 1 },
+        { "a\\x4Fb", 3 },
+        { "\\", SLICE_INVALID },
+        { "abc\\", SLICE_INVALID },
+        { "\\x4", SLICE_INVALID },
+        { "\\xg0", SLICE_INVALID },
+        { "\\n", SLICE_INVALID },
+    };
+
+    for (u64 i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        char output[16];
+        Slice text = {cases[i].text, strlen(cases[i].text)};
+        u64 length = Slice_Unescape(text, output);
+
+        if (length != cases[i].expected || Slice_Unescape(text, NULL) != length) {
+            Quit(1, "%s: unescaping '%s' gave %lu, expected %lu.", __FILE__, cases[i].text, length, cases[i].expected);
+        }
+    }
+}
+
+int
+main(void)
+{
+    Test_Unescape();
+    Test_Reader();
+    Test_SplitLines();
+    Test_ReadLine();
+
+    return 0;
+}
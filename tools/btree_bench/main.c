@@ -0,0 +1,175 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Compares BTree against BinaryTree on u64 keys.
+//
+// Usage: btree_bench [count]
+//
+// Inserts count keys scattered over the whole u64 range, then looks every
+// one of them up in an unrelated order so each lookup starts cold, and
+// finally walks the keys in order. Times are per operation.
+
+#include <time.h>
+
+#define BENCH_DEFAULT_COUNT 1000000
+
+static f64
+Bench_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (f64) now.tv_sec + (f64) now.tv_nsec * 1e-9;
+}
+
+// Keys come from a multiplicative hash of the index, which is a bijection on
+// u64, so they are distinct. Lookups visit the indexes through a second,
+// coprime stride.
+static inline u64
+Bench_Key(u64 index)
+{
+    return index * 0x9E3779B97F4A7C15ULL;
+}
+
+static inline u64
+Bench_LookupIndex(u64 i, u64 count)
+{
+    return (i * 2654435761ULL) % count;
+}
+
+static void
+Bench_Report(const char *name, f64 insert, f64 find, f64 scan, u64 count)
+{
+    printf("%-10s insert %7.1f ns  find %7.1f ns  scan %5.1f ns\n",
+        name,
+        insert * 1e9 / (f64) count,
+        find * 1e9 / (f64) count,
+        scan * 1e9 / (f64) count
+    );
+}
+
+static u64
+Bench_BTree(u64 count)
+{
+    BTree *tree = NULL;
+    u64 checksum = 0;
+
+    BTree_Create(&tree, (BTreeConfig) {.value_size = sizeof(u64)});
+
+    f64 start = Bench_Now();
+
+    for (u64 i = 0; i < count; ++i) {
+        BTree_Insert(tree, Bench_Key(i), &i);
+    }
+
+    f64 inserted = Bench_Now();
+
+    for (u64 i = 0; i < count; ++i) {
+        u64 *value = BTree_Find(tree, Bench_Key(Bench_LookupIndex(i, count)));
+
+        checksum += *value;
+    }
+
+    f64 found = Bench_Now();
+
+    BTreeIterator iterator = BTree_Iterate(tree);
+    u64 key;
+    void *value;
+
+    while (BTreeIterator_Next(&iterator, &key, &value)) {
+        checksum ^= key;
+    }
+
+    f64 scanned = Bench_Now();
+
+    Bench_Report("BTree", inserted - start, found - inserted, scanned - found, count);
+
+    BTree_Destroy(&tree);
+
+    return checksum;
+}
+
+static u64
+Bench_BinaryTree(u64 count)
+{
+    BinaryTree *tree = NULL;
+    u64 checksum = 0;
+
+    BinaryTree_Create(&tree, (BinaryTreeConfig) {
+        .key_size = sizeof(u64),
+        .value_size = sizeof(u64),
+        .compare = BinaryTree_CompareU64,
+    });
+
+    f64 start = Bench_Now();
+
+    for (u64 i = 0; i < count; ++i) {
+        u64 key = Bench_Key(i);
+
+        BinaryTree_Insert(tree, &key, &i);
+    }
+
+    f64 inserted = Bench_Now();
+
+    for (u64 i = 0; i < count; ++i) {
+        u64 key = Bench_Key(Bench_LookupIndex(i, count));
+        u64 *value = BinaryTree_Find(tree, &key);
+
+        checksum += *value;
+    }
+
+    f64 found = Bench_Now();
+
+    BinaryTreeIterator iterator = BinaryTree_Iterate(tree);
+    BinaryTreeEntry entry;
+
+    while (BinaryTreeIterator_Next(&iterator, &entry)) {
+        u64 key;
+
+        memcpy(&key, entry.key, sizeof(key));
+
+        checksum ^= key;
+    }
+
+    f64 scanned = Bench_Now();
+
+    Bench_Report("BinaryTree", inserted - start, found - inserted, scanned - found, count);
+
+    BinaryTree_Destroy(&tree);
+
+    return checksum;
+}
+
+int
+main(int argc, char **argv)
+{
+    u64 count = BENCH_DEFAULT_COUNT;
+
+    if (argc > 2) {
+        Quit(1, "usage: btree_bench [count]");
+    }
+
+    if (argc == 2) {
+        count = strtoull(argv[1], NULL, 10);
+
+        if (count == 0) {
+            Quit(1, "btree_bench: invalid count '%s'.", argv[1]);
+        }
+    }
+
+#if defined(__AVX2__)
+    printf("%lu keys, AVX2 node search\n", count);
+#else
+    printf("%lu keys, scalar node search\n", count);
+#endif
+
+    u64 btree = Bench_BTree(count);
+    u64 binary_tree = Bench_BinaryTree(count);
+
+    if (btree != binary_tree) {
+        Quit(2, "btree_bench: checksums differ (%lu, %lu).", btree, binary_tree);
+    }
+
+    return 0;
+}
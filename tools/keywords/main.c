@@ -0,0 +1,223 @@
+// Copyright (c) 2023 Gustavo Ribeiro Croscato
+// SPDX-License-Identifier: MIT
+
+// Generates a header with a perfect hash lookup for a keyword list.
+//
+// Usage: keywords <input> <output> <type> <function> <invalid>
+//
+// Each non-empty input line is "<value> <keyword>", where value is the enum
+// constant returned for the keyword and the keyword is the rest of the line
+// (it may contain spaces). The generated function hashes the keyword length
+// and its first, middle and last bytes into a table slot and confirms the
+// hit with a single compare.
+//
+// The hash is perfect but not necessarily minimal. The search starts at one
+// slot per keyword and takes the first table size, up to four times that,
+// for which some multipliers work, so the table may have empty slots. When
+// the lengths alone tell the keywords apart all multipliers come out as 0.
+
+#define KEYWORDS_MAX 256
+#define KEYWORDS_MULTIPLIER 64
+
+typedef struct Keyword {
+    Slice value;
+    Slice text;
+} Keyword;
+
+typedef struct KeywordHash {
+    u64 size;
+    u64 first;
+    u64 middle;
+    u64 last;
+} KeywordHash;
+
+static Keyword Keywords[KEYWORDS_MAX];
+static u64 KeywordCount = 0;
+
+static u64
+Keyword_Hash(const Slice text, KeywordHash hash)
+{
+    return (
+        text.size +
+        (u64) (u8) text.data[0] * hash.first +
+        (u64) (u8) text.data[text.size / 2] * hash.middle +
+        (u64) (u8) text.data[text.size - 1] * hash.last
+    ) % hash.size;
+}
+
+static bool
+Keyword_Check(KeywordHash hash, u8 *used)
+{
+    memset(used, 0, hash.size);
+
+    for (u64 i = 0; i < KeywordCount; ++i) {
+        u64 slot = Keyword_Hash(Keywords[i].text, hash);
+
+        if (used[slot]) {
+            return false;
+        }
+
+        used[slot] = 1;
+    }
+
+    return true;
+}
+
+static KeywordHash
+Keyword_Search(void)
+{
+    u8 used[KEYWORDS_MAX * 4];
+
+    for (u64 size = KeywordCount; size <= KeywordCount * 4; ++size) {
+        for (u64 first = 0; first < KEYWORDS_MULTIPLIER; ++first) {
+            for (u64 last = 0; last < KEYWORDS_MULTIPLIER; ++last) {
+                for (u64 middle = 0; middle < KEYWORDS_MULTIPLIER; ++middle) {
+                    KeywordHash hash = {size, first, middle, last};
+
+                    if (Keyword_Check(hash, used)) {
+                        return hash;
+                    }
+                }
+            }
+        }
+    }
+
+    Quit(3, "keywords: no perfect hash found for %lu keywords.", KeywordCount);
+}
+
+static void
+Keyword_Parse(const Slice input)
+{
+    SliceIterator lines = Slice_Iterate(input);
+
+    while (1) {
+        Slice line = SliceIterator_NextLine(&lines);
+
+        if (line.data == NULL) {
+            break;
+        }
+
+        if (line.size > 0 && line.data[line.size - 1] == '\r') {
+            line.size--;
+        }
+
+        if (line.size == 0) {
+            continue;
+        }
+
+        if (KeywordCount == KEYWORDS_MAX) {
+            Quit(2, "keywords: more than %d keywords.", KEYWORDS_MAX);
+        }
+
+        Keyword *keyword = &Keywords[KeywordCount++];
+
+        keyword->value = Slice_Token(&line, " ");
+        keyword->text = line;
+
+        if (keyword->value.size == 0 || keyword->text.size == 0) {
+            Quit(2, "keywords: invalid line '%.*s'.", (int) keyword->value.size, keyword->value.data);
+        }
+
+        for (u64 i = 0; i + 1 < KeywordCount; ++i) {
+            if (Slice_Equals(Keywords[i].text, keyword->text)) {
+                Quit(2, "keywords: duplicated keyword '%.*s'.", (int) line.size, line.data);
+            }
+        }
+    }
+
+    if (KeywordCount == 0) {
+        Quit(2, "keywords: empty keyword list.");
+    }
+}
+
+static void
+Keyword_Write(FILE *output, const char *source, const char *type, const char *function, const char *invalid)
+{
+    KeywordHash hash = Keyword_Search();
+
+    const Keyword **table = calloc(hash.size, sizeof(Keyword *));
+
+    if (table == NULL) {
+        Quit(-1, "keywords: out of memory.");
+    }
+
+    for (u64 i = 0; i < KeywordCount; ++i) {
+        table[Keyword_Hash(Keywords[i].text, hash)] = &Keywords[i];
+    }
+
+    fprintf(output, "// Generated by tools/keywords from %s, do not edit.\n\n", source);
+    fprintf(output, "static inline %s\n%s(const Slice token)\n{\n", type, function);
+    fprintf(output, "    static const struct {\n");
+    fprintf(output, "        const char *text;\n");
+    fprintf(output, "        u64 size;\n");
+    fprintf(output, "        %s value;\n", type);
+    fprintf(output, "    } table[%lu] = {\n", hash.size);
+
+    for (u64 i = 0; i < hash.size; ++i) {
+        if (table[i] == NULL) {
+            fprintf(output, "        { NULL, 0, %s },\n", invalid);
+
+            continue;
+        }
+
+        char *literal = malloc(Slice_Escape(table[i]->text, NULL));
+
+        if (literal == NULL) {
+            Quit(-1, "keywords: out of memory.");
+        }
+
+        u64 size = Slice_Escape(table[i]->text, literal);
+
+        fprintf(output, "        { %.*s, %lu, %.*s },\n",
+            (int) size, literal, table[i]->text.size, (int) table[i]->value.size, table[i]->value.data
+        );
+
+        free(literal);
+    }
+
+    fprintf(output, "    };\n\n");
+    fprintf(output, "    if (token.data == NULL || token.size == 0) {\n");
+    fprintf(output, "        return %s;\n", invalid);
+    fprintf(output, "    }\n\n");
+    fprintf(output, "    u64 slot = (\n");
+    fprintf(output, "        token.size +\n");
+    fprintf(output, "        (u64) (u8) token.data[0] * %lu +\n", hash.first);
+    fprintf(output, "        (u64) (u8) token.data[token.size / 2] * %lu +\n", hash.middle);
+    fprintf(output, "        (u64) (u8) token.data[token.size - 1] * %lu\n", hash.last);
+    fprintf(output, "    ) %% %lu;\n\n", hash.size);
+    fprintf(output, "    if (table[slot].size != token.size || memcmp(table[slot].text, token.data, token.size) != 0) {\n");
+    fprintf(output, "        return %s;\n", invalid);
+    fprintf(output, "    }\n\n");
+    fprintf(output, "    return table[slot].value;\n");
+    fprintf(output, "}\n");
+
+    free(table);
+}
+
+int
+main(int argc, char **argv)
+{
+    if (argc != 6) {
+        Quit(1, "usage: keywords <input> <output> <type> <function> <invalid>");
+    }
+
+    Slice input = Slice_MapFile(argv[1]);
+
+    if (input.data == NULL) {
+        Quit(1, "keywords: empty input '%s'.", argv[1]);
+    }
+
+    Keyword_Parse(input);
+
+    FILE *output = fopen(argv[2], "w");
+
+    if (output == NULL) {
+        Quit(1, "keywords: can't create '%s' (%s).", argv[2], strerror(errno));
+    }
+
+    Keyword_Write(output, argv[1], argv[3], argv[4], argv[5]);
+
+    fclose(output);
+
+    return 0;
+}